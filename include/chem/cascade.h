@@ -0,0 +1,90 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_CASCADE_H
+#define CHEM_CASCADE_H
+
+#include <chem/conformer_arena.h>
+#include <chem/molecule.h>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Chem {
+
+// Class providing a two-level screening cascade of potentials.
+//
+// Every structure is first optimized with the cheap potential. Only
+// structures that are within an energy window of the lowest cheap energy
+// found so far, that are not duplicates of previously screened structures,
+// and that rank among the lowest fraction of screened energies are
+// promoted to the expensive potential. Structures that are not promoted
+// are flagged as failed by setting the energy to zero.
+//
+// The cheap energies are given in the units of the cheap potential, and
+// the screening history is shared between copies of the cascade.
+//
+template <class Cheap, class Expensive>
+class Cascade {
+public:
+    Cascade();
+
+    Cascade(std::istream& from, const std::string& key = "Cascade");
+
+    // Initialize cascade and both potentials.
+    void init(std::istream& from, const std::string& key = "Cascade");
+
+    // Perform geometry optimization.
+    void run(Molecule& mol) const;
+
+    // Perform geometry optimization of a batch of molecules. The cheap
+    // level runs in a separate thread, feeding promoted structures to the
+    // expensive level as soon as they are screened.
+    void run_batch(std::vector<Molecule>& mols) const;
+
+private:
+    // Struct for holding the screening history.
+    struct History {
+        std::mutex mtx;
+        Conformer_arena screened;   // structures passed to screening
+        std::vector<double> echeap; // sorted cheap energies
+    };
+
+    // Run cheap potential and check if structure should be promoted.
+    bool screen(Molecule& mol) const;
+
+    // Flag structure as not promoted.
+    void reject(Molecule& mol) const;
+
+    Cheap cheap;
+    Expensive expensive;
+
+    double ewin; // energy window relative to lowest cheap energy
+    double xtol; // RMSD for duplicate structures
+    double frac; // fraction of screened structures that are promoted
+
+    std::shared_ptr<History> hist;
+};
+
+template <class Cheap, class Expensive>
+inline Cascade<Cheap, Expensive>::Cascade()
+    : ewin(50.0), xtol(0.1), frac(0.25), hist(std::make_shared<History>())
+{
+}
+
+template <class Cheap, class Expensive>
+inline Cascade<Cheap, Expensive>::Cascade(std::istream& from,
+                                          const std::string& key)
+    : Cascade()
+{
+    init(from, key);
+}
+
+} // namespace Chem
+
+#endif // CHEM_CASCADE_H
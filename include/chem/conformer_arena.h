@@ -0,0 +1,130 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_CONFORMER_ARENA_H
+#define CHEM_CONFORMER_ARENA_H
+
+#include <chem/element.h>
+#include <numlib/matrix.h>
+#include <stdutils/stdutils.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Chem {
+
+// Class for storing all conformers of one molecule as a structure of arrays.
+//
+// Cartesian coordinates of all conformers are kept in one contiguous array,
+// with energies and usage counters in parallel arrays. The atoms are stored
+// once. Conformers are accessed by rank; sorting permutes the ranks and
+// never moves coordinates.
+//
+class Conformer_arena {
+public:
+    Conformer_arena() = default;
+
+    explicit Conformer_arena(const std::vector<Element>& at) : atms(at) {}
+
+    // Copy semantics:
+    Conformer_arena(const Conformer_arena&) = default;
+    Conformer_arena& operator=(const Conformer_arena&) = default;
+
+    // Move semantics:
+    Conformer_arena(Conformer_arena&&) = default;
+    Conformer_arena& operator=(Conformer_arena&&) = default;
+
+    ~Conformer_arena() = default;
+
+    // Get number of conformers.
+    std::size_t size() const { return rank.size(); }
+
+    // Check if arena is empty.
+    bool empty() const { return rank.empty(); }
+
+    // Get number of atoms.
+    std::size_t num_atoms() const { return atms.size(); }
+
+    // Get atoms.
+    const auto& atoms() const { return atms; }
+
+    // Get energy of conformer i.
+    double energy(std::size_t i) const { return energies[rank[i]]; }
+
+    // Get usage counter of conformer i.
+    int usage(std::size_t i) const { return usages[rank[i]]; }
+
+    // Increment usage counter of conformer i.
+    void use(std::size_t i) { usages[rank[i]] += 1; }
+
+    // Get pointer to packed Cartesian coordinates of conformer i.
+    const double* xyz_data(std::size_t i) const
+    {
+        return coords.data() + rank[i] * stride();
+    }
+
+    // Get Cartesian coordinates of conformer i.
+    Numlib::Mat<double> get_xyz(std::size_t i) const;
+
+    // Copy Cartesian coordinates of conformer i into xyz.
+    void get_xyz(std::size_t i, Numlib::Mat<double>& xyz) const;
+
+    // Add conformer.
+    void push_back(double e, const Numlib::Mat<double>& xyz);
+
+    // Remove conformer with the highest rank.
+    void pop_back();
+
+    // Keep only the n first ranked conformers.
+    void truncate(std::size_t n);
+
+    // Sort conformers in ascending order of energy.
+    void sort();
+
+    // Check if a conformer with RMSD less than rmsd_max from xyz is stored.
+    bool contains(const Numlib::Mat<double>& xyz, double rmsd_max) const;
+
+    // Check if a conformer with RMSD less than rmsd_max from xyz and
+    // energy within etol of e is stored.
+    bool contains(const Numlib::Mat<double>& xyz,
+                  double rmsd_max,
+                  double e,
+                  double etol) const;
+
+private:
+    // Number of coordinates per conformer.
+    std::size_t stride() const { return 3 * atms.size(); }
+
+    // Release storage slot by moving the last slot into it.
+    void erase_slot(std::size_t slot);
+
+    std::vector<Element> atms;     // atoms
+    std::vector<double> coords;    // packed Cartesian coordinates
+    std::vector<double> energies;  // conformer energies
+    std::vector<int> usages;       // usage counters
+    std::vector<std::size_t> rank; // storage slot of each ranked conformer
+};
+
+inline Numlib::Mat<double> Conformer_arena::get_xyz(std::size_t i) const
+{
+    Numlib::Mat<double> xyz(atms.size(), 3);
+    get_xyz(i, xyz);
+    return xyz;
+}
+
+inline void Conformer_arena::get_xyz(std::size_t i,
+                                     Numlib::Mat<double>& xyz) const
+{
+    Assert::dynamic(xyz.rows() == narrow_cast<Index>(atms.size()) &&
+                        xyz.cols() == 3,
+                    "bad size of Cartesian coordinates");
+    const double* src = xyz_data(i);
+    std::copy(src, src + stride(), xyz.data());
+}
+
+} // namespace Chem
+
+#endif // CHEM_CONFORMER_ARENA_H
@@ -0,0 +1,143 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_DECOMPRESS_STREAM_H
+#define CHEM_DECOMPRESS_STREAM_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Chem {
+
+// Compression formats recognized by their magic bytes.
+enum class Compression { none, gzip, xz, zstd };
+
+// Detect compression format from the first bytes of a file.
+Compression detect_compression(const unsigned char* magic, std::size_t n);
+
+//------------------------------------------------------------------------------
+
+// Class providing a stream buffer for reading files that may be compressed.
+//
+// The format is detected by magic bytes; uncompressed files are read as
+// is. gzip, xz and zstd are supported if the library was built with zlib,
+// liblzma and libzstd, respectively. The file is decompressed in a
+// background thread that reads ahead of the consumer.
+//
+// Seeking is supported with decompressed offsets. Seeks within the
+// current chunk are free. Otherwise decompression is restarted: for gzip
+// files from the nearest access point recorded while decompressing (one
+// per megabyte of output), and for the other formats from the beginning
+// of the file. Seeking relative to the end is not supported.
+//
+class Decompress_buf : public std::streambuf {
+public:
+    Decompress_buf();
+
+    Decompress_buf(const Decompress_buf&) = delete;
+    Decompress_buf& operator=(const Decompress_buf&) = delete;
+
+    ~Decompress_buf() override;
+
+    // Open file; returns false if the file cannot be opened. Throws
+    // std::runtime_error if the compression format is not supported.
+    bool open(const std::string& filename);
+
+    // Close file.
+    void close();
+
+    bool is_open() const { return decoder != nullptr; }
+
+    Compression compression() const { return format; }
+
+    // Class interface for decoders.
+    class Decoder;
+
+protected:
+    int_type underflow() override;
+
+    pos_type seekoff(off_type off,
+                     std::ios_base::seekdir way,
+                     std::ios_base::openmode which) override;
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+    // Start and stop the decompression thread.
+    void start();
+    void stop();
+
+    // Move to decompressed offset.
+    bool restart(std::uint64_t pos);
+
+    static constexpr std::size_t chunk_size = 1 << 20;
+    static constexpr std::size_t read_ahead = 4; // max chunks queued
+
+    Compression format;
+    std::unique_ptr<Decoder> decoder;
+
+    std::vector<char> chunk; // chunk being consumed
+    std::uint64_t chunk_pos; // decompressed offset of chunk
+
+    std::thread worker;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<std::vector<char>> queue;
+    bool done;
+    bool halt;
+    std::exception_ptr error;
+};
+
+//------------------------------------------------------------------------------
+
+// Class providing an input stream for reading files that may be
+// compressed; it can be used in place of std::ifstream.
+class Decompress_istream : public std::istream {
+public:
+    Decompress_istream() : std::istream(nullptr) { init(&buf); }
+
+    explicit Decompress_istream(const std::string& filename)
+        : std::istream(nullptr)
+    {
+        init(&buf);
+        open(filename);
+    }
+
+    // Open file; failbit is set if the file cannot be opened. Throws
+    // std::runtime_error if the compression format is not supported.
+    void open(const std::string& filename)
+    {
+        if (buf.open(filename)) {
+            clear();
+        }
+        else {
+            setstate(std::ios_base::failbit);
+        }
+    }
+
+    void close() { buf.close(); }
+
+    bool is_open() const { return buf.is_open(); }
+
+    Compression compression() const { return buf.compression(); }
+
+private:
+    Decompress_buf buf;
+};
+
+} // namespace Chem
+
+#endif // CHEM_DECOMPRESS_STREAM_H
@@ -0,0 +1,136 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_FORCEFIELD_H
+#define CHEM_FORCEFIELD_H
+
+#include <chem/molecule.h>
+#include <numlib/matrix.h>
+#include <array>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace Chem {
+
+// Class providing a simple generic force field with a built-in L-BFGS
+// geometry optimizer, for running local optimizations in-process.
+//
+// Bonds are perceived from interatomic distances, with atoms bonded if
+// closer than 1.2 times the sum of their covalent radii, so that ring
+// closures are included. Bond stretches are harmonic with reference
+// lengths from covalent radii, angle bends are harmonic in the cosine with
+// reference angles from the coordination of the central atom, and torsions
+// about bonds between sp3 (sp2) centres are threefold (twofold) cosine
+// terms.
+// Atom pairs separated by more than two bonds interact through
+// Lennard-Jones (UFF parameters) and Coulomb potentials, with 1-4
+// interactions scaled. Energies are given in kJ/mol. Since strain energies
+// are often positive, a failed optimization sets the energy to infinity
+// rather than zero.
+//
+// Algorithms:
+//   Cordero, B. et al. Dalton Trans., 2008, pp. 2832-2838.
+//   Rappe, A. K. et al. J. Am. Chem. Soc., 1992, vol. 114, pp. 10024-10035.
+//   Nocedal, J.; Wright, S. J. Numerical Optimization; Springer, 2006.
+//
+class Forcefield {
+public:
+    Forcefield();
+
+    Forcefield(std::istream& from, const std::string& key = "Forcefield");
+
+    // Initialize force field.
+    void init(std::istream& from, const std::string& key = "Forcefield");
+
+    // Perform geometry optimization; the energy is set to infinity if the
+    // optimization fails.
+    void run(Molecule& mol) const;
+
+    // Perform geometry optimization of a batch of molecules in parallel.
+    void run_batch(std::vector<Molecule>& mols) const;
+
+    // Compute force field energy for the current geometry.
+    double energy(const Molecule& mol) const;
+
+private:
+    // Struct for holding the force field terms of a molecule.
+    struct Topology {
+        std::vector<std::array<Index, 2>> bonds;
+        std::vector<std::array<Index, 3>> angles;
+        std::vector<std::array<Index, 4>> torsions;
+        std::vector<std::array<Index, 2>> pairs;
+
+        std::vector<double> r0;    // reference bond lengths
+        std::vector<double> cos0;  // cosine of reference angles
+        std::vector<double> vtors; // torsional barriers
+        std::vector<int> ntors;    // torsional periodicities
+        std::vector<double> sigma; // Lennard-Jones diameters of pairs
+        std::vector<double> eps;   // Lennard-Jones well depths of pairs
+        std::vector<double> qq;    // charge products of pairs
+    };
+
+    // Set up force field terms from bonds perceived at current geometry.
+    Topology set_topology(const Molecule& mol) const;
+
+    // Compute energy and Cartesian gradient.
+    double energy_grad(const Topology& top,
+                       const std::vector<double>& x,
+                       std::vector<double>& g) const;
+
+    // Minimize energy using the limited-memory BFGS method.
+    bool lbfgs(const Topology& top, std::vector<double>& x, double& e) const;
+
+    double k_bond;     // bond stretch force constant
+    double k_angle;    // angle bend force constant
+    double v_tors;     // torsional barrier
+    double scale14;    // scaling of 1-4 non-bonded interactions
+    double dielectric; // dielectric constant
+    double gtol;       // convergence threshold for RMS gradient
+    int maxiter;       // max number of optimization steps
+    int nhist;         // number of L-BFGS correction pairs
+
+    Numlib::Vec<double> charges; // atomic partial charges
+};
+
+inline Forcefield::Forcefield()
+{
+    k_bond = 1400.0;
+    k_angle = 400.0;
+    v_tors = 6.0;
+    scale14 = 0.5;
+    dielectric = 1.0;
+    gtol = 1.0e-3;
+    maxiter = 1000;
+    nhist = 8;
+}
+
+inline Forcefield::Forcefield(std::istream& from, const std::string& key)
+    : Forcefield()
+{
+    init(from, key);
+}
+
+// Get default upper bound on energies of structures accepted by the
+// conformer searches with potential Pot. Zero rejects failed optimizations
+// with electronic structure methods, whereas force field energies are
+// often positive and failures are infinite.
+template <class Pot>
+inline double energy_max_default()
+{
+    return 0.0;
+}
+
+template <>
+inline double energy_max_default<Forcefield>()
+{
+    return std::numeric_limits<double>::max();
+}
+
+} // namespace Chem
+
+#endif // CHEM_FORCEFIELD_H
@@ -8,7 +8,7 @@
 #define CHEM_GAMCS_H
 
 #include <chem/molecule.h>
-#include <chem/conformer.h>
+#include <chem/conformer_arena.h>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -115,10 +115,10 @@ private:
 
     std::string select_method; // selection algorithm
 
-    std::vector<Conformer> population; // population of optimized structures
-    std::vector<Conformer> blacklist;  // population of blacklisted structures
-    std::vector<double> fitness;       // fitness of population
-    std::vector<double> min_energy;    // energies of most stable conformer
+    Conformer_arena population;     // population of optimized structures
+    Conformer_arena blacklist;      // population of blacklisted structures
+    std::vector<double> fitness;    // fitness of population
+    std::vector<double> min_energy; // energies of most stable conformer
 
     std::mt19937_64 mt; // random number engine
 };
@@ -160,8 +160,8 @@ inline void Gamcs<Pot>::select_parents(Molecule& parent1, Molecule& parent2)
     else {
         select_parents_random(indx1, indx2);
     }
-    parent1.set_xyz(population[indx1].xyz);
-    parent2.set_xyz(population[indx2].xyz);
+    parent1.set_xyz(population.get_xyz(indx1));
+    parent2.set_xyz(population.get_xyz(indx2));
 }
 
 template <class Pot>
@@ -175,7 +175,7 @@ inline void Gamcs<Pot>::select_parents_elite(std::size_t& indx1,
 template <class Pot>
 inline void Gamcs<Pot>::sort_population()
 {
-    std::sort(population.begin(), population.end());
+    population.sort();
 }
 
 } // namespace Chem
@@ -8,6 +8,7 @@
 #define CHEM_GAUSS_DATA_H
 
 #include <numlib/matrix.h>
+#include <stdutils/stdutils.h>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -48,12 +49,36 @@ struct Gauss_NMR_line {
     }
 };
 
+// Class for writing array values five per line in fchk format.
+class Fchk_writer {
+public:
+    explicit Fchk_writer(std::ostream& to_);
+
+    // Write values.
+    void put(double value);
+    void put(const std::vector<double>& values);
+
+    // End last line of array.
+    void finish();
+
+private:
+    std::ostream& to;
+    Stdutils::Format<double> sci;
+    int count;
+    bool wrote_endl;
+};
+
 //------------------------------------------------------------------------------
 
 //
 // Class providing methods for extracting data from Gaussian output files and
 // formatted checkpoint files.
 //
+// On first use, the file is indexed in one sweep by recording the byte
+// offsets of all recognized sections. Getters seek directly to their
+// sections, and the index is reused by all later calls. Byte offsets are
+// counted assuming lines terminated by '\n'.
+//
 class Gauss_data {
 public:
     Gauss_data(std::istream& from_, Gauss_filetype type)
@@ -98,6 +123,11 @@ public:
     // Get number of calculated IRC points including starting point.
     int get_no_irc_points() const;
 
+    // Get number of Cartesian coordinates of each IRC point. For fchk files
+    // this is given by the size of the IRC geometry array, since files
+    // written by sortirc and mergeirc hold only the IRC arrays.
+    int get_irc_natoms3() const;
+
     // Get VMEP and SMEP values for each optimized IRC point.
     void get_irc_data(std::vector<double>& mep) const;
 
@@ -110,6 +140,15 @@ public:
     // Get Hessians for each optimized IRC point (only for output files).
     void get_irc_hess(std::vector<double>& hess) const;
 
+    // Get VMEP and SMEP values, geometry, gradient or Hessian of IRC point k
+    // only, where points are counted from zero as returned by
+    // get_irc_data(). Long paths can thus be processed point by point and
+    // in any order.
+    void get_irc_data(int k, double& vmep, double& smep) const;
+    void get_irc_geom(int k, std::vector<double>& geom) const;
+    void get_irc_grad(int k, std::vector<double>& grad) const;
+    void get_irc_hess(int k, std::vector<double>& hess) const;
+
     // Get ModRedundant coordinate.
     std::string get_modredundant_coord() const;
 
@@ -117,8 +156,61 @@ public:
     void print_opt_geom(std::ostream& to = std::cout) const;
 
 private:
+    // Sections recognized by the index.
+    enum Section {
+        sec_cite,              // Cite this work as:
+        sec_error,             // Error termination
+        sec_stationary,        // Stationary point found.
+        sec_input,             // Input orientation:
+        sec_distance,          // Distance matrix
+        sec_std_orient,        // Standard orientation:
+        sec_zmat_orient,       // Z-Matrix orientation:
+        sec_zpe,               // Zero-point correction=
+        sec_sum_zpe,           // Sum of electronic and zero-point Energies=
+        sec_freqs,             // Frequencies --
+        sec_scan_summary,      // Summary of Optimized Potential Surface Scan
+        sec_init_params,       // Initial Parameters
+        sec_opt_point,         // -- Optimized point #
+        sec_irc_summary_g03,   // Summary of reaction path following:
+        sec_irc_summary,       // SUMMARY OF REACTION PATH FOLLOWING:
+        sec_forces,            // Center Atomic Forces
+        sec_second_deriv,      // The second derivative matrix:
+        sec_fchk_natoms,       // Number of atoms
+        sec_fchk_atnum,        // Atomic numbers
+        sec_fchk_xyz,          // Current cartesian coordinates
+        sec_fchk_force_const,  // Cartesian Force Constants
+        sec_fchk_irc_results,  // IRC point 1 Results for each geome
+        sec_fchk_irc_geom,     // IRC point 1 Geometries
+        sec_fchk_irc_grad,     // IRC point 1 Gradient at each geome
+        num_sections
+    };
+
+    // Get offsets of all lines starting a section; the file is indexed on
+    // first call.
+    const std::vector<std::streamoff>& section(Section sec) const;
+
+    // Index file in one sweep.
+    void build_index() const;
+
+    // Move to offset in file.
+    void seek(std::streamoff pos) const;
+
+    // Read geometry, forces or Hessian preceding optimized point k of an
+    // output file; x is zero-filled if no block is found.
+    void read_irc_geom(std::size_t k,
+                       int natoms,
+                       Gauss_version version,
+                       double* x) const;
+    void read_irc_forces(std::size_t k, int natoms, double* x) const;
+    void read_irc_hess(std::size_t k, int nhess, double* x) const;
+
+    // Read elements [first, first + n) of fchk array in section sec.
+    bool read_fchk_block(Section sec, int first, int n, double* x) const;
+
     std::istream& from;
     Gauss_filetype filetype;
+
+    mutable std::vector<std::vector<std::streamoff>> index;
 };
 
 } // namespace Chem
@@ -7,14 +7,32 @@
 #ifndef CHEM_GAUSSIAN_H
 #define CHEM_GAUSSIAN_H
 
+#include <chem/guess_store.h>
 #include <chem/molecule.h>
+#include <chem/process.h>
+#include <chem/qm_cache.h>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace Chem {
 
 // Wrapper class for running Gaussian calculations.
 //
+// While Gaussian runs, the log file is monitored and the job is killed if
+// one of the abort criteria is met:
+//   abort_energy: SCF energy above this value after abort_min_steps steps
+//   abort_steps:  optimization steps exceed this number
+//   abort_stall:  lowest SCF energy not improved for this number of steps
+// Aborted jobs are treated as failed calculations.
+//
+// If a guess store is given (guess_dir), the checkpoint file of the stored
+// structure closest to the new structure is used as initial guess. Read is
+// then merged into any guess option of the keywords (guess=mix becomes
+// guess=(read,mix)); the store is not used if the guess option selects
+// another source of the initial guess.
+//
 class Gaussian {
 public:
     Gaussian();
@@ -27,15 +45,42 @@ public:
     // Run Gaussian calculation.
     void run(Molecule& mol) const;
 
+    // Run Gaussian calculations for a batch of molecules. The jobs are run
+    // one after the other, each using nprocshared processors.
+    void run_batch(std::vector<Molecule>& mols) const;
+
 private:
-    // Create Gaussian input file.
-    void write_com(const Molecule& mol) const;
+    // Create Gaussian input file; the guess is read from oldchk if given.
+    void write_com(const Molecule& mol, const std::string& oldchk = "") const;
+
+    // Monitor Gaussian log file; returns false if the job was aborted.
+    bool monitor(Process& proc) const;
+
+    // Check if any abort criteria are set.
+    bool abort_requested() const
+    {
+        return abort_energy < emax_default || abort_steps > 0 ||
+               abort_stall > 0;
+    }
+
+    static constexpr double emax_default = 1.0e+300;
 
     std::string version;  // Gaussian version
     std::string keywords; // list of Gaussian keywords
     std::string jobname;  // Gaussian job name
     int nprocshared;      // number of processors
     bool nosave;          // flag to specify if chk file should be saved
+
+    double abort_energy; // abort if SCF energy is above this value
+    int abort_min_steps; // min steps before energy criterion is checked
+    int abort_steps;     // abort if number of steps exceeds this value
+    int abort_stall;     // abort if no improvement for this many steps
+    int poll_ms;         // polling interval for log file (ms)
+
+    double guess_rmsd; // max RMSD for using a stored guess
+
+    std::shared_ptr<Qm_cache> cache;    // cache of results (optional)
+    std::shared_ptr<Guess_store> guess; // store of checkpoint files
 };
 
 inline Gaussian::Gaussian()
@@ -45,6 +90,12 @@ inline Gaussian::Gaussian()
     jobname = "gauss";
     nprocshared = 1;
     nosave = true;
+    abort_energy = emax_default;
+    abort_min_steps = 3;
+    abort_steps = 0;
+    abort_stall = 0;
+    poll_ms = 200;
+    guess_rmsd = 0.5;
 }
 
 inline Gaussian::Gaussian(std::istream& from, const std::string& key)
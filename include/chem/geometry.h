@@ -19,6 +19,10 @@ namespace Chem {
 
 // Class for handling molecular geometries.
 //
+// The Z matrix is rebuilt lazily when first accessed after the Cartesian
+// coordinates have been set. Hence, const member functions may update the
+// Z matrix and must not be called concurrently on the same object.
+//
 class Geometry {
 public:
     Geometry() = default;
@@ -89,7 +93,10 @@ private:
     //
     // Note: It is assumed that bonded atoms are closer than non-bonded atoms.
     // This may not work well for transition states and molecular complexes.
-    void build_zmat();
+    void build_zmat() const;
+
+    // Build Z matrix if the Cartesian coordinates have changed.
+    void update_zmat() const;
 
     // Convert Z matrix to Cartesian coordinates. The code is based on the
     // qcl code written by Ben Albrecht released under the MIT license.
@@ -110,19 +117,22 @@ private:
     std::vector<Element> atms;
     Numlib::Mat<double> xyz;
 
-    Numlib::Vec<double> distances;
-    Numlib::Vec<double> angles;
-    Numlib::Vec<double> dihedrals;
+    mutable Numlib::Vec<double> distances;
+    mutable Numlib::Vec<double> angles;
+    mutable Numlib::Vec<double> dihedrals;
 
-    Numlib::Vec<Index> bond_connect;
-    Numlib::Vec<Index> angle_connect;
-    Numlib::Vec<Index> dihedral_connect;
+    mutable Numlib::Vec<Index> bond_connect;
+    mutable Numlib::Vec<Index> angle_connect;
+    mutable Numlib::Vec<Index> dihedral_connect;
+
+    mutable bool zmat_ok = true; // Z matrix is up to date
 
     std::string info;
 };
 
 inline double Geometry::get_distance(Index index) const
 {
+    update_zmat();
     double res = 0.0;
     if (atms.size() > 1) {
         res = distances(index);
@@ -132,6 +142,7 @@ inline double Geometry::get_distance(Index index) const
 
 inline double Geometry::get_angle(Index index) const
 {
+    update_zmat();
     double res = 0.0;
     if (atms.size() > 2) {
         res = angles(index);
@@ -141,6 +152,7 @@ inline double Geometry::get_angle(Index index) const
 
 inline double Geometry::get_dihedral(Index index) const
 {
+    update_zmat();
     double res = 0.0;
     if (atms.size() > 3) {
         res = dihedrals(index);
@@ -153,11 +165,12 @@ inline void Geometry::set_xyz(const Numlib::Mat<double>& x)
     Assert::dynamic(Numlib::same_extents(xyz, x),
                     "bad size of Cartesian coordinates");
     xyz = x;
-    build_zmat();
+    zmat_ok = false;
 }
 
 inline void Geometry::set_distance(Index index, double value)
 {
+    update_zmat();
     if (atms.size() > 1) {
         distances(index) = value;
         build_xyz();
@@ -166,6 +179,7 @@ inline void Geometry::set_distance(Index index, double value)
 
 inline void Geometry::set_angle(Index index, double value)
 {
+    update_zmat();
     if (atms.size() > 2) {
         angles(index) = value;
         build_xyz();
@@ -174,6 +188,7 @@ inline void Geometry::set_angle(Index index, double value)
 
 inline void Geometry::set_dihedral(Index index, double value)
 {
+    update_zmat();
     if (atms.size() > 3) {
         dihedrals(index) = value;
         build_xyz();
@@ -184,12 +199,22 @@ inline void Geometry::load_xyz(std::istream& from)
 {
     read_xyz_format(from, atms, xyz, info);
     build_zmat();
+    zmat_ok = true;
+}
+
+inline void Geometry::update_zmat() const
+{
+    if (!zmat_ok) {
+        build_zmat();
+        zmat_ok = true;
+    }
 }
 
 inline void Geometry::load_zmat(std::istream& from)
 {
     read_zmat_format(from, atms, distances, angles, dihedrals, bond_connect,
                      angle_connect, dihedral_connect);
+    zmat_ok = true;
     build_xyz();
 }
 
@@ -200,6 +225,7 @@ inline void Geometry::print_xyz(std::ostream& to) const
 
 inline void Geometry::print_zmat(std::ostream& to) const
 {
+    update_zmat();
     print_zmat_format(to, atms, distances, angles, dihedrals, bond_connect,
                       angle_connect, dihedral_connect);
 }
@@ -0,0 +1,58 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_GUESS_STORE_H
+#define CHEM_GUESS_STORE_H
+
+#include <chem/molecule.h>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Chem {
+
+// Class providing a store of wavefunction files (e.g. Gaussian checkpoint
+// or Mopac density files) indexed by optimized structure.
+//
+// Files are copied into the store directory together with the structure
+// they belong to. The file of the stored structure closest to a new
+// structure (by RMSD) can then be used as initial guess. When the store
+// is full, the oldest entry is replaced.
+//
+class Guess_store {
+public:
+    Guess_store(const std::string& dir,
+                const std::string& ext,
+                std::size_t nmax = 50);
+
+    // Copy file of the stored structure closest to mol to dest; returns
+    // false if no structure is within rmsd_max.
+    bool fetch(const Molecule& mol, double rmsd_max, const std::string& dest);
+
+    // Store copy of file for structure mol.
+    void store(const Molecule& mol, const std::string& file);
+
+    // Get number of stored structures.
+    std::size_t size() const { return coords.size(); }
+
+private:
+    std::string store_dir; // store directory
+    std::string file_ext;  // extension of stored files
+    std::size_t max_size;  // max number of stored files
+    std::size_t next;      // entry to be replaced when store is full
+
+    std::mutex mtx;
+    std::vector<std::vector<double>> coords; // stored structures
+    std::vector<std::string> files;          // stored files
+};
+
+// Copy file; returns false on failure.
+bool copy_file(const std::string& src, const std::string& dest);
+
+} // namespace Chem
+
+#endif // CHEM_GUESS_STORE_H
@@ -0,0 +1,34 @@
+// Copyright (c) 2009-2018 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_IRC_MERGE_H
+#define CHEM_IRC_MERGE_H
+
+#include <chem/gauss_data.h>
+#include <iostream>
+#include <vector>
+
+namespace Chem {
+
+// Merge IRC points of formatted checkpoint files which have been sorted,
+// such as files written by sortirc.
+//
+// The files may be given in any order; points are merged by reaction
+// coordinate (SMEP) in the direction of the first file, and points with
+// the same reaction coordinate as the previous point are written once,
+// which removes duplicates at segment boundaries. Points are streamed
+// from the files using a heap holding the next point of each file, so
+// memory does not grow with the number of points.
+//
+// The IRC arrays are written to the stream in fchk format; the stream must
+// be seekable since the size of the first array is patched when the number
+// of merged points is known. Returns the number of merged points.
+//
+int merge_irc(const std::vector<const Gauss_data*>& segs, std::ostream& to);
+
+} // namespace Chem
+
+#endif // CHEM_IRC_MERGE_H
@@ -7,39 +7,145 @@
 #ifndef CHEM_ISING_H
 #define CHEM_ISING_H
 
+#include <chem/ising_snapshot.h>
+#include <chem/philox.h>
 #include <numlib/matrix.h>
 #include <numlib/math.h>
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <memory>
 #include <random>
+#include <string>
 #include <vector>
 
 namespace Chem {
 
 // Class providing the two-dimensional Ising model.
 //
+// Metropolis sweeps update the two sublattices of a red/black checkerboard
+// in turn; all sites of one colour are updated in parallel. The random
+// number for a site is drawn from a counter-based generator keyed by the
+// seed and indexed by site and sweep, so results for a given seed do not
+// depend on the number of threads. Sublattices are only updated in
+// parallel if the lattice size is even; otherwise periodic boundaries
+// couple sites of the same colour.
+//
+// The Wolff and Swendsen-Wang cluster algorithms are provided to avoid
+// critical slowing down near the critical temperature. Bonds between
+// satisfied neighbours are activated with probability 1 - exp(-2|J|/T),
+// and clusters are flipped subject to the external field. A Wolff step
+// grows and flips single clusters until as many sites as in the lattice
+// have been visited, so that all algorithms count steps in sweeps. The
+// acceptance of cluster flips drops quickly with the external field, hence
+// the cluster algorithms are only efficient in weak fields.
+//
+// Snapshots of the lattice at the sampling steps given by the vizualisation
+// steps are written to a single binary file (see ising_snapshot.h) by a
+// background thread.
+//
+// The structure factor S(k) = <|sum_r s_r exp(-i k r)|^2> / N, with
+// k = 2 pi (m, n) / L, is optionally measured at a given stride of
+// sweeps during sampling. The lattice is Fourier transformed by a
+// mixed-radix FFT, with Bluestein's algorithm for large prime factors, at a
+// cost of O(N log N) per measurement unless L has two or more large prime
+// factors. The correlation function G(r) = <s_0 s_r> is obtained as the
+// inverse transform of S(k).
+//
+// Energy and magnetisation are tracked as integer sums updated with the
+// change of each accepted move, and are checked against a full
+// recomputation at regular intervals.
+//
 class Ising2D {
 public:
     Ising2D(
         int sz, double j, double b, const std::vector<int>& v, int seed = 0);
 
-    // Perform Metropolis algorithm.
+    // Perform Metropolis algorithm. Returns the energy, absolute
+    // magnetisation, heat capacity and susceptibility per site.
     std::array<double, 4> metropolis(double temp, int mc_trials = 1000);
 
+    // Perform Wolff single-cluster algorithm. Returns the averages of
+    // metropolis() followed by the integrated autocorrelation times of the
+    // energy and the absolute magnetisation in sweeps.
+    std::array<double, 6> wolff(double temp, int mc_trials = 1000);
+
+    // Perform Swendsen-Wang algorithm. Returns the same results as wolff().
+    std::array<double, 6> swendsen_wang(double temp, int mc_trials = 1000);
+
+    // Set name of snapshot file (default ising.snap).
+    void set_snapshot_file(const std::string& filename)
+    {
+        snap_file = filename;
+    }
+
+    // Set number of sweeps between measurements of the structure factor;
+    // no measurements are made if zero (default).
+    void set_corr_stride(int stride) { corr_stride = stride; }
+
+    // Get structure factor averaged over the last sampling.
+    const Numlib::Mat<double>& structure_factor() const { return sfac; }
+
+    // Get spin-spin correlation function averaged over the last sampling.
+    Numlib::Mat<double> correlation() const;
+
+    // Get second-moment correlation length from the structure factor at
+    // k = 0 and the smallest non-zero wave vector. Since S(0) includes the
+    // spontaneous magnetisation, it is only meaningful at and above the
+    // critical temperature.
+    double correlation_length() const;
+
+    // Perform one Metropolis sweep at given temperature.
+    void metropolis_sweep(double temp) { mc_spin_flip(1.0 / temp); }
+
+    // Get lattice size.
+    int get_size() const { return size; }
+
+    // Get sum of s_i s_j over nearest-neighbour bonds.
+    long long get_bond_sum() const { return bond_sum; }
+
+    // Get sum of spins.
+    long long get_spin_sum() const { return spin_sum; }
+
+    // Get lattice energy for sums of bonds and spins.
+    double get_energy(long long bsum, long long msum) const
+    {
+        return -jint * static_cast<double>(bsum) -
+               bfield * static_cast<double>(msum);
+    }
+
 private:
+    // Equilibrate and sample the lattice using the given sweep.
+    std::array<double, 6> sample(double temp,
+                                 int mc_trials,
+                                 void (Ising2D::*update)(double));
+
     // Initialise spins for the ground state.
     void init_spins();
 
-    // Perform Monte Carlo sampling of spin flips.
+    // Perform one Metropolis sweep over the lattice.
     void mc_spin_flip(double beta);
 
-    // Visualize spin matrix.
-    void visualize_if_requested(double temp, int it) const;
+    // Perform Wolff cluster flips for one sweep over the lattice.
+    void wolff_update(double beta);
 
-    // Compute lattice energy.
+    // Perform one Swendsen-Wang update of the lattice.
+    void sw_update(double beta);
+
+    // Add structure factor of current lattice to averages.
+    void measure_corr();
+
+    // Write snapshot of spin matrix.
+    void visualize_if_requested(double temp, int it);
+
+    // Compute lattice energy and magnetisation from scratch.
     void compute_energy_magn();
 
-    // Compute magnetisation.
-    double magnetisation() const;
+    // Check tracked energy and magnetisation against full recomputation.
+    void check_energy_magn();
+
+    // Update lattice energy and magnetisation from tracked sums.
+    void set_energy_magn();
 
     // Periodic boundary conditions.
     int pbc(int i) const;
@@ -51,23 +157,53 @@ private:
     double energy; // lattice energy
     double magn;   // net magnetisation
 
+    long long bond_sum; // sum of s_i s_j over nearest-neighbour bonds
+    long long spin_sum; // sum of spins
+
     Numlib::Mat<int> spins; // spin matrix
-    std::vector<int> viz;
+    std::vector<int> viz;   // vizualisation steps (sorted)
+
+    std::string snap_file;                  // snapshot file
+    std::unique_ptr<Snapshot_writer> snap; // opened at first snapshot
 
-    std::mt19937_64 mt; // random number engine
+    int corr_stride;          // sweeps between structure factor measurements
+    int ncorr;                // number of measurements
+    Numlib::Mat<double> sfac; // structure factor
+
+    Philox4x32 rng;      // counter-based random number generator
+    std::uint64_t sweep; // number of sweeps performed
 };
 
+// Compute integrated autocorrelation time of series.
+//
+// The autocorrelation function is summed up to the smallest window W with
+// W >= c tau, using the automatic windowing of Sokal. An uncorrelated
+// series gives 0.5, and the variance of the mean is var(x) 2 tau / n.
+//
+// Reference:
+//     Sokal, A. D. (1997). Monte Carlo methods in statistical mechanics:
+//     Foundations and new algorithms. In Functional Integration, pp. 131-192.
+//
+double autocorr_time(const std::vector<double>& x, double c = 5.0);
+
 inline Ising2D::Ising2D(
     int sz, double j, double b, const std::vector<int>& v, int seed)
-    : size(sz), jint(j), bfield(b), viz(v)
+    : size(sz),
+      jint(j),
+      bfield(b),
+      viz(v),
+      snap_file("ising.snap"),
+      corr_stride(0),
+      ncorr(0),
+      sweep(0)
 {
+    std::sort(viz.begin(), viz.end());
     if (seed == 0) {
         std::random_device rd;
-        std::seed_seq ss{rd(), rd(), rd(), rd(), rd(), rd(), rd(), rd()};
-        mt.seed(ss);
+        rng = Philox4x32((static_cast<std::uint64_t>(rd()) << 32) ^ rd());
     }
     else {
-        mt.seed(seed); // should only be used for testing
+        rng = Philox4x32(seed); // should only be used for testing
     }
     init_spins();
 }
@@ -75,11 +211,13 @@ inline Ising2D::Ising2D(
 inline void Ising2D::init_spins()
 {
     spins = Numlib::ones<Numlib::Mat<int>>(size, size);
+    compute_energy_magn();
 }
 
-inline double Ising2D::magnetisation() const
+inline void Ising2D::set_energy_magn()
 {
-    return static_cast<double>(Numlib::sum(spins.ravel()));
+    magn = static_cast<double>(spin_sum);
+    energy = get_energy(bond_sum, spin_sum);
 }
 
 inline int Ising2D::pbc(int i) const { return (i + size) % size; }
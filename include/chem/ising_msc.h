@@ -0,0 +1,106 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_ISING_MSC_H
+#define CHEM_ISING_MSC_H
+
+#include <chem/ising_snapshot.h>
+#include <chem/philox.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Chem {
+
+// Class providing the two-dimensional Ising model with multi-spin coding.
+//
+// Spins are stored as bits, 64 spins per word, with the two sublattices
+// of the red/black checkerboard in separate arrays. A sublattice is
+// updated 64 spins at a time: the number of antiparallel neighbours is
+// counted with bitwise adders, and spins are accepted by comparing
+// bit-sliced random numbers with tabulated acceptance probabilities for
+// each spin value and neighbour count. Random numbers are drawn from a
+// counter-based generator indexed by word and sweep, so results for a
+// given seed do not depend on the number of threads.
+//
+// The lattice size must be a multiple of 128.
+//
+class Ising2D_msc {
+public:
+    Ising2D_msc(
+        int sz, double j, double b, const std::vector<int>& v, int seed = 0);
+
+    // Perform Metropolis algorithm. Returns the energy, absolute
+    // magnetisation, heat capacity and susceptibility per site.
+    std::array<double, 4> metropolis(double temp, int mc_trials = 1000);
+
+    // Get spin at lattice site.
+    int spin(int i, int j) const;
+
+    // Set name of snapshot file (default ising.snap).
+    void set_snapshot_file(const std::string& filename)
+    {
+        snap_file = filename;
+    }
+
+private:
+    // Initialise spins for the ground state.
+    void init_spins();
+
+    // Tabulate acceptance probabilities.
+    void set_acceptance(double beta);
+
+    // Perform one Metropolis sweep over the lattice.
+    void mc_spin_flip();
+
+    // Update sublattice of given colour.
+    void update(int color, std::uint64_t n);
+
+    // Write snapshot of spin matrix.
+    void visualize_if_requested(double temp, int it);
+
+    // Compute lattice energy and magnetisation.
+    void compute_energy_magn();
+
+    // Get words with the two neighbours in the same row of the spins in
+    // word w of row i of the sublattice of given colour.
+    void row_neighbours(int color,
+                        int i,
+                        int w,
+                        std::uint64_t& nb1,
+                        std::uint64_t& nb2) const;
+
+    // Periodic boundary conditions.
+    int pbc(int i) const { return (i + size) % size; }
+
+    int size;      // lattice size
+    int nwords;    // words per row of each sublattice
+    double jint;   // interaction (ferromagnetic if positive)
+    double bfield; // external magnetic field
+
+    double energy; // lattice energy
+    double magn;   // net magnetisation
+
+    std::array<std::vector<std::uint64_t>, 2> lat; // sublattices; 1 is up
+    std::vector<int> viz; // vizualisation steps (sorted)
+
+    std::string snap_file;                  // snapshot file
+    std::unique_ptr<Snapshot_writer> snap; // opened at first snapshot
+
+    // Acceptance table for spin value (down, up) and number of
+    // antiparallel neighbours, as 32-bit thresholds:
+    std::array<std::uint32_t, 10> threshold;
+    std::array<bool, 10> always; // accepted without random number
+
+    Philox4x32 rng;      // counter-based random number generator
+    std::uint64_t sweep; // number of sweeps performed
+};
+
+} // namespace Chem
+
+#endif // CHEM_ISING_MSC_H
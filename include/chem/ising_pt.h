@@ -0,0 +1,89 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_ISING_PT_H
+#define CHEM_ISING_PT_H
+
+#include <chem/ising.h>
+#include <chem/philox.h>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace Chem {
+
+// Class providing parallel tempering of the two-dimensional Ising model.
+//
+// One replica is run at each temperature, with Metropolis sweeps of the
+// replicas performed in parallel. After each sweep, exchanges of
+// neighbouring temperatures are attempted, alternating between even and
+// odd pairs. Energy histograms from all temperatures are combined by
+// multiple-histogram reweighting, which gives averages at any temperature
+// within the range where the histograms overlap.
+//
+// References:
+//     Hukushima, K. and Nemoto, K. (1996). J. Phys. Soc. Jpn., 65, 1604.
+//     Ferrenberg, A. M. and Swendsen, R. H. (1989). Phys. Rev. Lett., 63,
+//     1195.
+//
+class Ising2D_pt {
+public:
+    Ising2D_pt(int sz,
+               double j,
+               double b,
+               const std::vector<double>& t,
+               int seed = 0);
+
+    // Perform parallel tempering. Returns the energy, absolute
+    // magnetisation, heat capacity and susceptibility per site at each
+    // temperature.
+    std::vector<std::array<double, 4>> tempering(int mc_trials = 1000);
+
+    // Get reweighted averages at given temperature from the histograms
+    // of the last call to tempering(). The multiple-histogram equations
+    // are solved on first call; throws if they do not converge.
+    std::array<double, 4> reweight(double temp) const;
+
+    // Get acceptance rate of exchanges between neighbouring temperatures.
+    std::vector<double> exchange_rates() const;
+
+private:
+    // Attempt exchanges of replicas between neighbouring temperatures.
+    void exchange(int parity);
+
+    // Solve multiple-histogram equations for the density of states.
+    void solve_histograms() const;
+
+    int size;      // lattice size
+    double jint;   // interaction (ferromagnetic if positive)
+    double bfield; // external magnetic field
+
+    std::vector<double> temps;     // temperatures
+    std::vector<Ising2D> replicas; // replicas
+    std::vector<int> rep_at;       // replica at each temperature
+
+    // Histogram over bond and spin sums for all temperatures:
+    std::map<std::pair<long long, long long>, long long> hist;
+
+    int ntrials; // samples per temperature in histogram
+
+    // Density of states for the histogram entries, computed on demand:
+    mutable std::vector<double> ener; // energy
+    mutable std::vector<double> magn; // net magnetisation
+    mutable std::vector<double> lng;  // logarithm of density of states
+
+    std::vector<long long> n_accept; // accepted exchanges
+    std::vector<long long> n_trial;  // attempted exchanges
+
+    Philox4x32 rng;      // random number generator for exchanges
+    std::uint64_t sweep; // number of sweeps performed
+};
+
+} // namespace Chem
+
+#endif // CHEM_ISING_PT_H
@@ -0,0 +1,129 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_ISING_SNAPSHOT_H
+#define CHEM_ISING_SNAPSHOT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Chem {
+
+// Snapshots of spin lattices are stored in a single file, with frames
+// appended as they are written and an index written when the file is
+// closed. The file has the following layout in host byte order:
+//
+//    char[8]   "CHEMSNP1"
+//    int32     number of rows
+//    int32     number of columns
+//    frames:   double temperature, int32 iteration, packed spins
+//    uint64    frame offsets (one per frame)
+//    uint64    number of frames
+//    uint64    offset of frame offsets
+//    char[8]   "CHEMSNPI"
+//
+// Spins are packed row by row, eight per byte, with bit i % 8 of byte i / 8
+// set if spin i is up. Since frames have a fixed size, files without index
+// (e.g. from an interrupted run) can still be read.
+
+// Pack spins given by a function of row and column; spins are up if
+// positive.
+template <class Spin>
+std::vector<std::uint8_t> pack_spins(int rows, int cols, Spin spin)
+{
+    std::vector<std::uint8_t> bits((rows * cols + 7) / 8, 0);
+    int n = 0;
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            if (spin(i, j) > 0) {
+                bits[n / 8] |= static_cast<std::uint8_t>(1 << (n % 8));
+            }
+            ++n;
+        }
+    }
+    return bits;
+}
+
+// Class providing an asynchronous writer of spin lattice snapshots.
+//
+// Frames are queued and written by a background thread, so that the
+// simulation only waits for I/O if the queue is full.
+//
+class Snapshot_writer {
+public:
+    Snapshot_writer(const std::string& filename,
+                    int rows,
+                    int cols,
+                    std::size_t max_queued = 8);
+
+    Snapshot_writer(const Snapshot_writer&) = delete;
+    Snapshot_writer& operator=(const Snapshot_writer&) = delete;
+
+    ~Snapshot_writer();
+
+    // Queue frame with packed spins for writing.
+    void write(double temp, int it, std::vector<std::uint8_t>&& spins);
+
+    // Write queued frames and index, and close file. Throws
+    // std::runtime_error if writing failed.
+    void close();
+
+private:
+    // Struct for holding a queued frame.
+    struct Frame {
+        double temp;
+        int it;
+        std::vector<std::uint8_t> spins;
+    };
+
+    // Write frames until closed.
+    void run();
+
+    std::ofstream to;
+    int nrows;
+    int ncols;
+    std::size_t max_queued;
+    std::vector<std::uint64_t> offsets; // offsets of frames written
+
+    std::thread worker;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<Frame> queue;
+    bool done;
+    std::exception_ptr error;
+};
+
+// Class providing a reader of spin lattice snapshots.
+class Snapshot_reader {
+public:
+    explicit Snapshot_reader(const std::string& filename);
+
+    int rows() const { return nrows; }
+    int cols() const { return ncols; }
+
+    // Get number of frames.
+    std::size_t size() const { return offsets.size(); }
+
+    // Read frame; spins are returned row by row as +1 or -1.
+    void read(std::size_t k, double& temp, int& it, std::vector<int>& spins);
+
+private:
+    std::ifstream from;
+    int nrows;
+    int ncols;
+    std::vector<std::uint64_t> offsets;
+};
+
+} // namespace Chem
+
+#endif // CHEM_ISING_SNAPSHOT_H
@@ -0,0 +1,142 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_ISING_WL_H
+#define CHEM_ISING_WL_H
+
+#include <chem/philox.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Chem {
+
+// Class providing Wang-Landau sampling of the two-dimensional Ising model
+// in zero field.
+//
+// The density of states g(E) is estimated by a random walk in energy which
+// accepts moves with probability g(E) / g(E'), while ln g(E) of the
+// current energy is increased by ln f. The modification factor is halved
+// each time the energy histogram is flat. Once ln f falls below the number
+// of levels divided by the number of moves, it is set to this ratio after
+// each sweep (the 1/t algorithm), which avoids the saturation of the error
+// of the original algorithm. Sampling stops when ln f is below the
+// requested value. Thermodynamic averages at any temperature are then
+// obtained from g(E).
+//
+// The energy range is split into overlapping windows, each sampled by its
+// own walker in parallel. Walkers in neighbouring windows exchange
+// configurations when both energies lie in the overlap, and the windows
+// are joined at the middle of their overlaps. The magnetisation is
+// sampled as microcanonical averages from the start of the last stage.
+//
+// References:
+//     Wang, F. and Landau, D. P. (2001). Phys. Rev. Lett., 86, 2050.
+//     Belardinelli, R. E. and Pereyra, V. D. (2007). Phys. Rev. E, 75,
+//     046701.
+//     Vogel, T., Li, Y. W., Wuest, T. and Landau, D. P. (2013). Phys. Rev.
+//     Lett., 110, 210603.
+//
+class Ising2D_wl {
+public:
+    Ising2D_wl(int sz,
+               double j,
+               int nwin = 4,
+               double overlap = 0.5,
+               int seed = 0);
+
+    // Estimate density of states.
+    void wang_landau(double lnf_final = 1.0e-6, double flatness = 0.8);
+
+    // Get energies of the sampled levels.
+    std::vector<double> energies() const;
+
+    // Get logarithm of density of states of the sampled levels, normalised
+    // to the total number of states.
+    const std::vector<double>& log_dos() const { return lng; }
+
+    // Get energy, absolute magnetisation, heat capacity and susceptibility
+    // per site at given temperature.
+    std::array<double, 4> thermo(double temp) const;
+
+private:
+    // Struct holding a lattice configuration.
+    struct Walker {
+        std::vector<int> spins;
+        long long bond_sum; // sum of s_i s_j over nearest-neighbour bonds
+        long long spin_sum; // sum of spins
+    };
+
+    // Struct holding the state of an energy window.
+    struct Window {
+        int kmin; // lowest level
+        int kmax; // highest level
+        double lnf;          // modification factor
+        bool one_over_t;     // ln f is set from the number of moves
+        bool done;           // ln f is below requested value
+        std::uint64_t moves; // moves performed, used as random counter
+        std::uint64_t steps; // moves performed by Wang-Landau sampling
+
+        std::vector<double> lng;      // logarithm of density of states
+        std::vector<long long> hist;  // energy histogram of current stage
+        std::vector<char> visited;    // levels visited
+        std::vector<long long> count; // samples of magnetisation
+        std::vector<double> mabs;     // sum of absolute magnetisation
+        std::vector<double> m2;       // sum of squared magnetisation
+    };
+
+    // Get level of bond sum.
+    int level(long long bsum) const
+    {
+        return static_cast<int>((2LL * size * size - bsum) / 4);
+    }
+
+    // Get number of reachable levels. On odd lattices each of the 2L rows
+    // and columns has at least one satisfied bond, so the highest level is
+    // N - L rather than N.
+    int num_levels() const
+    {
+        const int n2 = size * size;
+        return (size % 2 == 0 ? n2 : n2 - size) + 1;
+    }
+
+    // Perform single-spin flips in window; returns true if it is flat.
+    bool walk(int w, double flatness);
+
+    // Move walker of window into its energy range; throws if the range is
+    // not reached.
+    void init_walker(int w);
+
+    // Attempt exchanges of walkers between neighbouring windows.
+    void exchange(int parity);
+
+    // Join windows into density of states.
+    void join_windows();
+
+    // Flip spin and update sums of walker.
+    void flip(Walker& x, int site, int s_nb);
+
+    // Get sum of neighbour spins of site.
+    int neighbours(const Walker& x, int site) const;
+
+    int size;    // lattice size
+    double jint; // interaction (ferromagnetic if positive)
+
+    std::vector<Window> windows;
+    std::vector<Walker> walkers; // walker of each window
+
+    std::vector<long long> levels; // bond sums of the sampled levels
+    std::vector<double> lng;       // logarithm of density of states
+    std::vector<double> mabs;      // average absolute magnetisation
+    std::vector<double> m2;        // average squared magnetisation
+
+    Philox4x32 rng;      // counter-based random number generator
+    std::uint64_t sweep; // number of sweeps performed
+};
+
+} // namespace Chem
+
+#endif // CHEM_ISING_WL_H
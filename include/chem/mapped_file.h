@@ -0,0 +1,166 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_MAPPED_FILE_H
+#define CHEM_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace Chem {
+
+//------------------------------------------------------------------------------
+
+// Struct providing a non-owning view of a range of characters.
+struct Text_view {
+    const char* ptr = nullptr;
+    std::size_t len = 0;
+
+    Text_view() = default;
+    Text_view(const char* p, std::size_t n) : ptr(p), len(n) {}
+
+    const char* begin() const { return ptr; }
+    const char* end() const { return ptr + len; }
+
+    std::size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+
+    char operator[](std::size_t i) const { return ptr[i]; }
+
+    // Find pattern; returns std::string::npos if not found.
+    std::size_t find(const char* pattern, std::size_t pos = 0) const;
+
+    std::size_t find(const std::string& pattern, std::size_t pos = 0) const
+    {
+        return find(pattern.c_str(), pos);
+    }
+
+    bool contains(const char* pattern) const
+    {
+        return find(pattern) != std::string::npos;
+    }
+
+    bool contains(const std::string& pattern) const
+    {
+        return find(pattern) != std::string::npos;
+    }
+
+    // Get view of characters [pos, pos + n).
+    Text_view substr(std::size_t pos, std::size_t n = std::string::npos) const;
+
+    // Copy to string.
+    std::string str() const { return std::string(ptr, len); }
+};
+
+//------------------------------------------------------------------------------
+
+// Class providing read-only access to the contents of a file.
+//
+// On POSIX systems the file is mapped into memory; on other systems it is
+// read into a buffer. Views into the file are valid for the lifetime of
+// the object.
+//
+class Mapped_file {
+public:
+    Mapped_file() = default;
+
+    // Open file; throws std::runtime_error if the file cannot be opened.
+    explicit Mapped_file(const std::string& filename);
+
+    // Mapped files cannot be copied:
+    Mapped_file(const Mapped_file&) = delete;
+    Mapped_file& operator=(const Mapped_file&) = delete;
+
+    ~Mapped_file() { close(); }
+
+    // Open file; returns false if the file cannot be opened.
+    bool open(const std::string& filename);
+
+    // Release file.
+    void close();
+
+    bool is_open() const { return opened; }
+
+    const char* data() const { return ptr; }
+    std::size_t size() const { return len; }
+
+    Text_view view() const { return Text_view(ptr, len); }
+
+private:
+    const char* ptr = nullptr;
+    std::size_t len = 0;
+    bool opened = false;
+    bool mapped = false;
+    std::string buf; // used if the file is not mapped
+};
+
+//------------------------------------------------------------------------------
+
+// Class for scanning the lines of a text forward and backward.
+//
+// Line terminators ('\n' and a preceding '\r') are not included in the
+// lines returned.
+//
+class Line_reader {
+public:
+    explicit Line_reader(Text_view text)
+        : first(text.begin()), last(text.end()), pos(text.begin())
+    {
+    }
+
+    // Get next line; returns false at end of text.
+    bool next(Text_view& line);
+
+    // Get line preceding the current position; returns false at beginning
+    // of text. Calling next() afterwards returns the same line again.
+    bool prev(Text_view& line);
+
+    // Move to the beginning or end of text.
+    void rewind() { pos = first; }
+    void seek_end() { pos = last; }
+
+    // Get or set current offset from beginning of text.
+    std::size_t tell() const { return static_cast<std::size_t>(pos - first); }
+    void seek(std::size_t off) { pos = first + (off < size() ? off : size()); }
+
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+
+private:
+    const char* first;
+    const char* last;
+    const char* pos;
+};
+
+//------------------------------------------------------------------------------
+
+// Get next whitespace-separated token, starting at p; p is moved past the
+// token. Returns an empty view if there are no more tokens.
+Text_view next_token(const char*& p, const char* end);
+
+// Get n'th whitespace-separated token (counting from zero) of text.
+Text_view get_token(Text_view text, int n);
+
+// Parse floating-point number starting at p (leading whitespace is
+// skipped); p is moved past the number. The decimal point is always '.',
+// independently of the C locale, and Fortran exponents (1.0D+00) are
+// accepted. Returns false if no number could be parsed.
+bool parse_double(const char*& p, const char* end, double& x);
+
+// Parse integer starting at p (leading whitespace is skipped); p is moved
+// past the number. Returns false if no number could be parsed.
+bool parse_int(const char*& p, const char* end, long& x);
+
+// Parse all of text as a floating-point number; surrounding whitespace is
+// allowed.
+bool parse_double(Text_view text, double& x);
+
+// Parse all of text as an integer; surrounding whitespace is allowed.
+bool parse_int(Text_view text, long& x);
+
+} // namespace Chem
+
+#endif // CHEM_MAPPED_FILE_H
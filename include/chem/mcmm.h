@@ -7,7 +7,7 @@
 #ifndef CHEM_MCMM_H
 #define CHEM_MCMM_H
 
-#include <chem/conformer.h>
+#include <chem/conformer_arena.h>
 #include <chem/molecule.h>
 #include <numlib/matrix.h>
 #include <numlib/math.h>
@@ -99,7 +99,7 @@ private:
     double ecurr;                // current energy
     std::vector<double> eglobal; // energy of global minimum
 
-    std::vector<Conformer> conformers; // array with local energy minima
+    Conformer_arena conformers; // local energy minima
 
     bool verbose;
     bool global_min_found = false;
@@ -139,8 +139,7 @@ inline void Mcmm<Pot>::gen_rand_conformer(Molecule& m)
 template <class Pot>
 void Mcmm<Pot>::save_conformer(const Molecule& m)
 {
-    Conformer c(m.elec().energy(), m.get_xyz());
-    conformers.push_back(c);
+    conformers.push_back(m.elec().energy(), m.get_xyz());
 }
 
 } // namespace Chem
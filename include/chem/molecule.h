@@ -20,6 +20,12 @@ namespace Chem {
 
 // Class for holding molecule objects.
 //
+// Setting the Cartesian coordinates only copies them. The rotational
+// analysis, the torsional analysis and the Z matrix are recomputed, and
+// the vibrations reset, when they are first accessed afterwards. Hence,
+// const member functions may update these and must not be called
+// concurrently on the same object.
+//
 class Molecule {
 public:
     Molecule() = default;
@@ -73,29 +79,58 @@ public:
     auto& geom() { return geom_; }
 
     // Get molecular rotation object.
-    const auto& rot() const { return rot_; }
+    const auto& rot() const
+    {
+        update();
+        return rot_;
+    }
 
     // Modify molecular rotations.
-    auto& rot() { return rot_; }
+    auto& rot()
+    {
+        update();
+        return rot_;
+    }
 
     // Get molecular vibrations object.
-    const auto& vib() const { return vib_; }
+    const auto& vib() const
+    {
+        update();
+        return vib_;
+    }
 
     // Modify molecular vibrations.
-    auto& vib() { return vib_; }
+    auto& vib()
+    {
+        update();
+        return vib_;
+    }
 
     // Get internal torsions object.
-    const auto& tor() const { return tor_; }
+    const auto& tor() const
+    {
+        update();
+        return tor_;
+    }
 
     // Modify internal torsions.
-    auto& tor() { return tor_; }
+    auto& tor()
+    {
+        update();
+        return tor_;
+    }
 
 private:
-    Electronic elec_; // electronic properties
-    Geometry geom_;   // molecular geometry
-    Rotation rot_;    // molecular rotations
-    Vibration vib_;   // molecular vibrations
-    Torsion tor_;     // internal torsional modes
+    // Recompute rotations and torsions if the geometry has changed.
+    void update() const;
+
+    Electronic elec_;       // electronic properties
+    Geometry geom_;         // molecular geometry
+    mutable Rotation rot_;  // molecular rotations
+    mutable Vibration vib_; // molecular vibrations
+    mutable Torsion tor_;   // internal torsional modes
+
+    mutable bool derived_ok = true; // rotations and torsions are up to date
 };
 
 inline Mol_type Molecule::structure() const
@@ -104,7 +139,7 @@ inline Mol_type Molecule::structure() const
     if (num_atoms() == 1) {
         res = atom;
     }
-    else if (rot_.constants().size() == 1) {
+    else if (rot().constants().size() == 1) {
         res = linear;
     }
     else {
@@ -118,12 +153,21 @@ inline void Molecule::set_xyz(const Numlib::Mat<double>& x)
     Assert::dynamic(Numlib::same_extents(geom_.get_xyz(), x),
                     "bad size of Cartesian coordinates");
 
-    // Geometry has changed; set molecule in proper state:
+    // Geometry has changed; derived properties are updated when needed:
     elec_.set_energy(0.0);
     geom_.set_xyz(x);
-    rot_.set(x);
-    vib_ = Vibration();
-    tor_.set(x, rot_.principal_axes(), rot_.principal_moments());
+    derived_ok = false;
+}
+
+inline void Molecule::update() const
+{
+    if (!derived_ok) {
+        const auto& x = geom_.get_xyz();
+        rot_.set(x);
+        vib_ = Vibration();
+        tor_.set(x, rot_.principal_axes(), rot_.principal_moments());
+        derived_ok = true;
+    }
 }
 
 } // namespace Chem
@@ -7,15 +7,27 @@
 #ifndef CHEM_MOPAC_H
 #define CHEM_MOPAC_H
 
+#include <chem/guess_store.h>
 #include <chem/molecule.h>
+#include <chem/qm_cache.h>
 #include <numlib/matrix.h>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace Chem {
 
 // Wrapper class for running Mopac calculations.
 //
+// Batches of molecules are run with one Mopac process per batch_size input
+// files. Batching is off by default (batch_size = 1), since the Mopac
+// version must accept several input files on the command line; a warning
+// is given if output files of a batch are missing.
+//
+// If a guess store is given (guess_dir), the density matrix of the stored
+// structure closest to the new structure is used as initial guess.
+//
 class Mopac {
 public:
     Mopac();
@@ -28,6 +40,9 @@ public:
     // Run Mopac calculation.
     void run(Molecule& mol) const;
 
+    // Run Mopac calculations for a batch of molecules.
+    void run_batch(std::vector<Molecule>& mols) const;
+
     // Check SCF convergence.
     bool check_convergence() const;
 
@@ -38,8 +53,29 @@ public:
     void get_xyz(Numlib::Mat<double>& xyz) const;
 
 private:
-    // Create Mopac input file.
-    void write_dat(const Molecule& mol) const;
+    // Struct for holding results read from Mopac output file.
+    struct Out_data {
+        bool converged = false;
+        bool heat_found = false;
+        bool xyz_found = false;
+        double heat = 0.0;
+    };
+
+    // Create Mopac input file; the density is read from the .den file
+    // if oldens is true.
+    void write_dat(const Molecule& mol,
+                   const std::string& name,
+                   bool oldens = false) const;
+
+    // Update molecule with results from output file; the calculation
+    // has failed if ok is false.
+    void update(Molecule& mol,
+                const std::string& name,
+                const std::string& cache_key,
+                bool ok) const;
+
+    // Read results from output file in one pass.
+    Out_data read_out(const std::string& name, Numlib::Mat<double>& xyz) const;
 
     // Write Cartesian coordinates in Mopac format.
     void write_xyz(std::ostream& to, const Molecule& mol) const;
@@ -48,6 +84,12 @@ private:
     std::string keywords; // list of Mopac keywords
     std::string jobname;  // Mopac job name
     int opt_geom;         // flag to specify geometry optimization
+    int batch_size;       // max number of input files per Mopac process
+
+    double guess_rmsd; // max RMSD for using a stored guess
+
+    std::shared_ptr<Qm_cache> cache;    // cache of results (optional)
+    std::shared_ptr<Guess_store> guess; // store of density files
 };
 
 inline Mopac::Mopac()
@@ -56,6 +98,8 @@ inline Mopac::Mopac()
     keywords = "PM6-D EF GEO-OK PRECISE";
     jobname = "mopac";
     opt_geom = 1; // perform geometry optimization
+    batch_size = 1;
+    guess_rmsd = 0.5;
 }
 
 inline Mopac::Mopac(std::istream& from, const std::string& key)
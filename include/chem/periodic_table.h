@@ -15,6 +15,10 @@ namespace Chem {
 
 // Namespace providing the Periodic Table of Elements.
 //
+// The element data are held in constant tables, and symbols are looked up
+// by binary search. Element_ref gives access to an isotope without copying
+// its data into an Element.
+//
 // Source:
 //   Zucker, M.A., Kishore, A.R., Sukumar, R., and Dragoset, R.A. (2015),
 //   Elemental Data Index (version 2.5). [Online]
@@ -27,6 +31,48 @@ namespace Periodic_table {
         Bad_atomic_symbol(std::string s) : std::domain_error(s) {}
     };
 
+    // Class providing a handle to an isotope in the periodic table.
+    class Element_ref {
+    public:
+        Element_ref() : idx(-1) {}
+        explicit Element_ref(int i) : idx(i) {}
+
+        // Check if handle refers to an isotope.
+        bool valid() const { return idx >= 0; }
+
+        // Get index of isotope in periodic table.
+        int index() const { return idx; }
+
+        const char* atomic_symbol() const;
+        int atomic_number() const;
+        int mass_number() const;
+        double atomic_mass() const;
+        double atomic_weight() const;
+        double isotope_comp() const;
+
+        // Get copy of element data.
+        Element element() const;
+
+    private:
+        int idx;
+    };
+
+    inline bool operator==(const Element_ref& a, const Element_ref& b)
+    {
+        return a.index() == b.index();
+    }
+
+    inline bool operator!=(const Element_ref& a, const Element_ref& b)
+    {
+        return !(a == b);
+    }
+
+    // Find isotope; returns an invalid handle if the symbol is unknown.
+    Element_ref find_element(const std::string& symbol);
+
+    // Get isotope; throws Bad_atomic_symbol if the symbol is unknown.
+    Element_ref get_element_ref(const std::string& symbol);
+
     Element get_element(const std::string& symbol);
     std::string get_atomic_symbol(const std::string& symbol);
     std::string get_atomic_symbol(int atomic_number);
@@ -45,14 +91,12 @@ namespace Periodic_table {
 
 inline std::string Periodic_table::get_atomic_symbol(const std::string& symbol)
 {
-    Element elem = get_element(symbol);
-    return elem.atomic_symbol;
+    return get_element_ref(symbol).atomic_symbol();
 }
 
 inline int Periodic_table::get_atomic_number(const std::string& symbol)
 {
-    Element elem = get_element(symbol);
-    return elem.atomic_number;
+    return get_element_ref(symbol).atomic_number();
 }
 
 inline int Periodic_table::get_max_atomic_number()
@@ -62,26 +106,22 @@ inline int Periodic_table::get_max_atomic_number()
 
 inline int Periodic_table::get_mass_number(const std::string& symbol)
 {
-    Element elem = get_element(symbol);
-    return elem.mass_number;
+    return get_element_ref(symbol).mass_number();
 }
 
 inline double Periodic_table::get_atomic_mass(const std::string& symbol)
 {
-    Element elem = get_element(symbol);
-    return elem.atomic_mass;
+    return get_element_ref(symbol).atomic_mass();
 }
 
 inline double Periodic_table::get_atomic_weight(const std::string& symbol)
 {
-    Element elem = get_element(symbol);
-    return elem.atomic_weight;
+    return get_element_ref(symbol).atomic_weight();
 }
 
 inline double Periodic_table::get_isotope_composition(const std::string& symbol)
 {
-    Element elem = get_element(symbol);
-    return elem.isotope_comp;
+    return get_element_ref(symbol).isotope_comp();
 }
 
 } // namespace Chem
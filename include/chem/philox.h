@@ -0,0 +1,86 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_PHILOX_H
+#define CHEM_PHILOX_H
+
+#include <array>
+#include <cstdint>
+
+namespace Chem {
+
+// Class providing the Philox4x32-10 counter-based random number generator.
+//
+// Each 128-bit counter is mapped to four independent 32-bit random numbers
+// by a keyed bijection, so random numbers can be drawn for any counter in
+// any order. Parallel streams are obtained by encoding e.g. the lattice
+// site and sweep number in the counter, making results independent of
+// the number of threads.
+//
+// Reference:
+//     Salmon, J. K., Moraes, M. A., Dror, R. O. and Shaw, D. E. (2011).
+//     Parallel random numbers: As easy as 1, 2, 3. Proceedings of SC11.
+//
+class Philox4x32 {
+public:
+    using ctr_type = std::array<std::uint32_t, 4>;
+    using key_type = std::array<std::uint32_t, 2>;
+
+    Philox4x32() : key{0, 0} {}
+
+    explicit Philox4x32(std::uint64_t seed)
+        : key{static_cast<std::uint32_t>(seed),
+              static_cast<std::uint32_t>(seed >> 32)}
+    {
+    }
+
+    // Get random numbers for counter.
+    ctr_type operator()(ctr_type ctr) const;
+
+    // Get random number in [0, 1) for the counter made of two 64-bit
+    // words.
+    double uniform(std::uint64_t c0, std::uint64_t c1) const;
+
+private:
+    key_type key;
+};
+
+inline Philox4x32::ctr_type Philox4x32::operator()(ctr_type ctr) const
+{
+    constexpr std::uint32_t m0 = 0xD2511F53;
+    constexpr std::uint32_t m1 = 0xCD9E8D57;
+    constexpr std::uint32_t w0 = 0x9E3779B9;
+    constexpr std::uint32_t w1 = 0xBB67AE85;
+
+    key_type k = key;
+    for (int r = 0; r < 10; ++r) {
+        const std::uint64_t p0 = static_cast<std::uint64_t>(m0) * ctr[0];
+        const std::uint64_t p1 = static_cast<std::uint64_t>(m1) * ctr[2];
+        ctr = {static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ k[0],
+               static_cast<std::uint32_t>(p1),
+               static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ k[1],
+               static_cast<std::uint32_t>(p0)};
+        k[0] += w0;
+        k[1] += w1;
+    }
+    return ctr;
+}
+
+inline double Philox4x32::uniform(std::uint64_t c0, std::uint64_t c1) const
+{
+    auto r = (*this)({static_cast<std::uint32_t>(c0),
+                      static_cast<std::uint32_t>(c0 >> 32),
+                      static_cast<std::uint32_t>(c1),
+                      static_cast<std::uint32_t>(c1 >> 32)});
+    // Use 53 random bits:
+    const std::uint64_t x =
+        (static_cast<std::uint64_t>(r[0]) << 21) ^ (r[1] >> 11);
+    return static_cast<double>(x) * (1.0 / 9007199254740992.0);
+}
+
+} // namespace Chem
+
+#endif // CHEM_PHILOX_H
@@ -0,0 +1,55 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_PROCESS_H
+#define CHEM_PROCESS_H
+
+#include <string>
+
+namespace Chem {
+
+// Class for running a shell command as a child process that can be polled
+// and killed while it runs.
+//
+// On POSIX systems the command runs in its own process group, hence
+// kill() also terminates any programs started by the command (e.g. the
+// links of a Gaussian job). On other systems the command is run to
+// completion by start(), and kill() has no effect.
+//
+class Process {
+public:
+    Process() = default;
+
+    explicit Process(const std::string& cmd) { start(cmd); }
+
+    // Processes cannot be copied:
+    Process(const Process&) = delete;
+    Process& operator=(const Process&) = delete;
+
+    // Wait for process on destruction.
+    ~Process();
+
+    // Start command.
+    void start(const std::string& cmd);
+
+    // Check if process is still running.
+    bool running();
+
+    // Wait for process to finish and get exit status.
+    int wait();
+
+    // Kill process and all its children.
+    void kill();
+
+private:
+    long pid = -1;    // process ID
+    int status = 0;   // exit status
+    bool done = true; // process has finished
+};
+
+} // namespace Chem
+
+#endif // CHEM_PROCESS_H
@@ -0,0 +1,70 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_QM_CACHE_H
+#define CHEM_QM_CACHE_H
+
+#include <chem/molecule.h>
+#include <numlib/matrix.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Chem {
+
+// Class providing an on-disk cache of results from external quantum
+// chemistry programs.
+//
+// Entries are keyed by a canonical string made from the method keywords,
+// the charge and spin multiplicity, the atoms, and the centered Cartesian
+// coordinates rounded to a tolerance. Each entry is stored in its own file
+// named by the 64-bit FNV-1a hash of the key. Files are written to a
+// temporary name and renamed into place, hence several processes can share
+// one cache directory. Entries read or written are also kept in memory,
+// guarded by a mutex.
+//
+class Qm_cache {
+public:
+    Qm_cache(const std::string& dir, double tol = 1.0e-4);
+
+    // Get cache key for running method on molecule.
+    std::string key(const std::string& method, const Molecule& mol) const;
+
+    // Look up key; if found, the stored coordinates and energy are
+    // copied to the molecule.
+    bool lookup(const std::string& key, Molecule& mol);
+
+    // Store coordinates and energy of molecule under key.
+    void store(const std::string& key, const Molecule& mol);
+
+private:
+    // Struct for holding a cache entry.
+    struct Entry {
+        double energy;
+        Numlib::Mat<double> xyz;
+    };
+
+    // Get path to file holding entry.
+    std::string path(const std::string& key) const;
+
+    // Read entry from file.
+    bool read_entry(const std::string& key, Entry& entry) const;
+
+    std::string cache_dir; // cache directory
+    double xtol;           // rounding tolerance for coordinates
+    std::uint64_t ntmp;    // counter for temporary file names
+
+    std::mutex mtx;
+    std::unordered_map<std::string, Entry> entries;
+};
+
+// Compute 64-bit FNV-1a hash of string.
+std::uint64_t fnv1a_hash(const std::string& str);
+
+} // namespace Chem
+
+#endif // CHEM_QM_CACHE_H
@@ -0,0 +1,55 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef CHEM_RMSD_H
+#define CHEM_RMSD_H
+
+#include <numlib/matrix.h>
+#include <stdutils/stdutils.h>
+#include <limits>
+
+namespace Chem {
+
+// Root-mean-square deviation between two structures after optimal
+// superposition, computed with the quaternion characteristic polynomial
+// (QCP) method.
+//
+// Algorithm:
+//   Theobald, D. L. Acta Cryst. A, 2005, vol. 61, pp. 478-480.
+//   Liu, P.; Agrafiotis, D. K.; Theobald, D. L. J. Comput. Chem., 2010,
+//   vol. 31, pp. 1561-1563.
+//
+// The coordinates are given as packed natoms x 3 arrays in row-major order.
+// No temporaries are allocated. If rmsd_max is given, the computation stops
+// as soon as the RMSD is known to exceed rmsd_max; the returned value is
+// then a lower bound on the RMSD which is larger than rmsd_max.
+double qcp_rmsd(const double* a,
+                const double* b,
+                Index natoms,
+                double rmsd_max = std::numeric_limits<double>::max());
+
+// QCP RMSD between two sets of Cartesian coordinates.
+inline double qcp_rmsd(const Numlib::Mat<double>& a,
+                       const Numlib::Mat<double>& b)
+{
+    Assert::dynamic(Numlib::same_extents(a, b),
+                    "bad size of Cartesian coordinates");
+    return qcp_rmsd(a.data(), b.data(), a.rows());
+}
+
+// QCP RMSD with early exit once the RMSD is known to exceed rmsd_max.
+inline double qcp_rmsd(const Numlib::Mat<double>& a,
+                       const Numlib::Mat<double>& b,
+                       double rmsd_max)
+{
+    Assert::dynamic(Numlib::same_extents(a, b),
+                    "bad size of Cartesian coordinates");
+    return qcp_rmsd(a.data(), b.data(), a.rows(), rmsd_max);
+}
+
+} // namespace Chem
+
+#endif // CHEM_RMSD_H
@@ -0,0 +1,165 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/cascade.h>
+#include <chem/forcefield.h>
+#include <chem/gaussian.h>
+#include <chem/mopac.h>
+#include <stdutils/stdutils.h>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <thread>
+
+template <class Cheap, class Expensive>
+void Chem::Cascade<Cheap, Expensive>::init(std::istream& from,
+                                           const std::string& key)
+{
+    // Read input data:
+
+    using namespace Stdutils;
+
+    auto pos = find_token(from, key);
+    if (pos != -1) {
+        get_token_value(from, pos, "ewin", ewin, 50.0);
+        get_token_value(from, pos, "xtol", xtol, 0.1);
+        get_token_value(from, pos, "frac", frac, 0.25);
+    }
+    Assert::dynamic(ewin > 0.0, "bad ewin <= 0.0");
+    Assert::dynamic(xtol > 0.0, "bad xtol <= 0.0");
+    Assert::dynamic(frac > 0.0 && frac <= 1.0, "bad frac");
+
+    cheap.init(from);
+    expensive.init(from);
+}
+
+template <class Cheap, class Expensive>
+void Chem::Cascade<Cheap, Expensive>::run(Chem::Molecule& mol) const
+{
+    if (screen(mol)) {
+        expensive.run(mol);
+    }
+    else {
+        reject(mol);
+    }
+}
+
+template <class Cheap, class Expensive>
+void Chem::Cascade<Cheap, Expensive>::run_batch(
+    std::vector<Chem::Molecule>& mols) const
+{
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<std::size_t> promoted;
+    bool done = false;
+    bool abort = false;
+    std::exception_ptr error = nullptr;
+
+    // Cheap level; screened structures are queued for the expensive level:
+    std::thread producer([&]() {
+        try {
+            for (std::size_t i = 0; i < mols.size(); ++i) {
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if (abort) {
+                        break;
+                    }
+                }
+                if (screen(mols[i])) {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    promoted.push_back(i);
+                    cv.notify_one();
+                }
+                else {
+                    reject(mols[i]);
+                }
+            }
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        done = true;
+        cv.notify_one();
+    });
+
+    // Expensive level:
+    try {
+        while (true) {
+            std::size_t i;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&]() { return done || !promoted.empty(); });
+                if (promoted.empty()) {
+                    break;
+                }
+                i = promoted.front();
+                promoted.pop_front();
+            }
+            expensive.run(mols[i]);
+        }
+    }
+    catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            abort = true;
+        }
+        producer.join();
+        throw;
+    }
+    producer.join();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template <class Cheap, class Expensive>
+bool Chem::Cascade<Cheap, Expensive>::screen(Chem::Molecule& mol) const
+{
+    cheap.run(mol);
+    const double e = mol.elec().energy();
+    if (e == 0.0 || !std::isfinite(e)) { // cheap optimization failed
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(hist->mtx);
+
+    if (hist->screened.empty()) {
+        hist->screened = Chem::Conformer_arena(mol.atoms());
+    }
+    else if (hist->screened.contains(mol.get_xyz(), xtol)) {
+        return false; // already screened
+    }
+    hist->screened.push_back(e, mol.get_xyz());
+
+    auto& ec = hist->echeap;
+    auto it = std::lower_bound(ec.begin(), ec.end(), e);
+    const auto rank = static_cast<double>(it - ec.begin());
+    ec.insert(it, e);
+
+    if (e > ec.front() + ewin) {
+        return false; // outside energy window
+    }
+    const double nmax = std::ceil(frac * static_cast<double>(ec.size()));
+    return rank < nmax;
+}
+
+template <class Cheap, class Expensive>
+void Chem::Cascade<Cheap, Expensive>::reject(Chem::Molecule& mol) const
+{
+    // Structure is not promoted; set energy to zero:
+    constexpr double emax = 0.0;
+    mol.elec().set_energy(emax);
+}
+
+template class Chem::Cascade<Chem::Forcefield, Chem::Forcefield>;
+template class Chem::Cascade<Chem::Forcefield, Chem::Gaussian>;
+template class Chem::Cascade<Chem::Forcefield, Chem::Mopac>;
+template class Chem::Cascade<Chem::Mopac, Chem::Gaussian>;
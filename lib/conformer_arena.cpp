@@ -0,0 +1,104 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/conformer_arena.h>
+#include <chem/rmsd.h>
+#include <cmath>
+
+void Chem::Conformer_arena::push_back(double e, const Numlib::Mat<double>& xyz)
+{
+    Assert::dynamic(xyz.rows() == narrow_cast<Index>(atms.size()) &&
+                        xyz.cols() == 3,
+                    "bad size of Cartesian coordinates");
+
+    rank.push_back(energies.size());
+    coords.insert(coords.end(), xyz.data(), xyz.data() + stride());
+    energies.push_back(e);
+    usages.push_back(0);
+}
+
+void Chem::Conformer_arena::pop_back()
+{
+    Assert::dynamic(!rank.empty(), "conformer arena is empty");
+    std::size_t slot = rank.back();
+    rank.pop_back();
+    erase_slot(slot);
+}
+
+void Chem::Conformer_arena::truncate(std::size_t n)
+{
+    while (rank.size() > n) {
+        pop_back();
+    }
+}
+
+void Chem::Conformer_arena::sort()
+{
+    std::stable_sort(rank.begin(), rank.end(),
+                     [&](std::size_t a, std::size_t b) {
+                         return energies[a] < energies[b];
+                     });
+}
+
+bool Chem::Conformer_arena::contains(const Numlib::Mat<double>& xyz,
+                                     double rmsd_max) const
+{
+    Assert::dynamic(xyz.rows() == narrow_cast<Index>(atms.size()),
+                    "bad size of Cartesian coordinates");
+
+    // Sweep the storage slots in memory order:
+    const Index natoms = narrow_cast<Index>(atms.size());
+    for (std::size_t slot = 0; slot < energies.size(); ++slot) {
+        const double* x = coords.data() + slot * stride();
+        if (Chem::qcp_rmsd(x, xyz.data(), natoms, rmsd_max) < rmsd_max) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Chem::Conformer_arena::contains(const Numlib::Mat<double>& xyz,
+                                     double rmsd_max,
+                                     double e,
+                                     double etol) const
+{
+    Assert::dynamic(xyz.rows() == narrow_cast<Index>(atms.size()),
+                    "bad size of Cartesian coordinates");
+
+    // Sweep the storage slots in memory order; the energy is checked
+    // first since it is much cheaper than the RMSD:
+    const Index natoms = narrow_cast<Index>(atms.size());
+    for (std::size_t slot = 0; slot < energies.size(); ++slot) {
+        if (std::abs(energies[slot] - e) > etol) {
+            continue;
+        }
+        const double* x = coords.data() + slot * stride();
+        if (Chem::qcp_rmsd(x, xyz.data(), natoms, rmsd_max) < rmsd_max) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+
+void Chem::Conformer_arena::erase_slot(std::size_t slot)
+{
+    // Keep storage dense by moving the last slot into the released one:
+    const std::size_t last = energies.size() - 1;
+    if (slot != last) {
+        std::copy(coords.begin() + last * stride(),
+                  coords.begin() + (last + 1) * stride(),
+                  coords.begin() + slot * stride());
+        energies[slot] = energies[last];
+        usages[slot] = usages[last];
+        auto it = std::find(rank.begin(), rank.end(), last);
+        *it = slot;
+    }
+    coords.resize(last * stride());
+    energies.pop_back();
+    usages.pop_back();
+}
@@ -0,0 +1,757 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/decompress_stream.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#ifdef CHEMAPPS_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef CHEMAPPS_HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef CHEMAPPS_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// Class interface for decoders producing decompressed data in sequence.
+class Chem::Decompress_buf::Decoder {
+public:
+    virtual ~Decoder() = default;
+
+    // Decompress up to n bytes into buf; returns 0 at end of data.
+    virtual std::size_t read(char* buf, std::size_t n) = 0;
+
+    // Move to decompressed offset pos; returns false if pos is beyond the
+    // end of data.
+    virtual bool seek(std::uint64_t pos)
+    {
+        if (pos < out) {
+            reset();
+        }
+        return skip(pos);
+    }
+
+protected:
+    // Restart decompression from the beginning of the file.
+    virtual void reset() = 0;
+
+    // Decompress and discard data up to offset pos.
+    bool skip(std::uint64_t pos)
+    {
+        std::vector<char> tmp(1 << 16);
+        while (out < pos) {
+            auto n = static_cast<std::size_t>(
+                std::min<std::uint64_t>(tmp.size(), pos - out));
+            if (read(tmp.data(), n) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::uint64_t out = 0; // decompressed bytes produced
+};
+
+namespace {
+
+using Decoder = Chem::Decompress_buf::Decoder;
+
+// Move to absolute offset in file.
+void file_seek(std::FILE* fp, std::uint64_t pos)
+{
+#ifdef _WIN32
+    int res = _fseeki64(fp, static_cast<__int64>(pos), SEEK_SET);
+#else
+    int res = fseeko(fp, static_cast<off_t>(pos), SEEK_SET);
+#endif
+    if (res != 0) {
+        throw std::runtime_error("could not seek in compressed file");
+    }
+}
+
+// Class owning a C file handle.
+class File {
+public:
+    explicit File(const std::string& filename)
+        : fp(std::fopen(filename.c_str(), "rb"))
+    {
+        if (!fp) {
+            throw std::runtime_error("cannot open " + filename);
+        }
+    }
+
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+
+    ~File() { std::fclose(fp); }
+
+    std::FILE* get() const { return fp; }
+
+private:
+    std::FILE* fp;
+};
+
+//------------------------------------------------------------------------------
+
+// Decoder for uncompressed files.
+class Plain_decoder : public Decoder {
+public:
+    explicit Plain_decoder(const std::string& filename) : file(filename) {}
+
+    std::size_t read(char* buf, std::size_t n) override
+    {
+        std::size_t nread = std::fread(buf, 1, n, file.get());
+        if (nread < n && std::ferror(file.get())) {
+            throw std::runtime_error("read error");
+        }
+        out += nread;
+        return nread;
+    }
+
+    bool seek(std::uint64_t pos) override
+    {
+        file_seek(file.get(), pos);
+        out = pos;
+        return true;
+    }
+
+protected:
+    void reset() override
+    {
+        file_seek(file.get(), 0);
+        out = 0;
+    }
+
+private:
+    File file;
+};
+
+//------------------------------------------------------------------------------
+
+#ifdef CHEMAPPS_HAVE_ZLIB
+
+// Decoder for gzip files, possibly with several members.
+//
+// Access points are recorded at deflate block boundaries about every
+// megabyte of output, holding the compressed offset and the last 32 kB of
+// output; decompression can be restarted at an access point with a raw
+// inflate primed with that window (as in zran.c from the zlib examples).
+//
+class Gzip_decoder : public Decoder {
+public:
+    explicit Gzip_decoder(const std::string& filename) : file(filename)
+    {
+        std::memset(&strm, 0, sizeof(strm));
+        if (inflateInit2(&strm, 47) != Z_OK) { // gzip or zlib header
+            throw std::runtime_error("inflateInit2 failed");
+        }
+    }
+
+    ~Gzip_decoder() override { inflateEnd(&strm); }
+
+    std::size_t read(char* buf, std::size_t n) override;
+
+    bool seek(std::uint64_t pos) override;
+
+protected:
+    void reset() override;
+
+private:
+    // Struct for holding an access point.
+    struct Point {
+        std::uint64_t out;       // decompressed offset
+        std::uint64_t in;        // compressed offset of next full byte
+        int bits;                // bits of the preceding byte still unused
+        std::vector<Bytef> win;  // window preceding the access point
+    };
+
+    // Read more compressed data; returns false at end of file.
+    bool fill();
+
+    // Copy output to window.
+    void update_window(const char* buf, std::size_t n);
+
+    // Record access point if at a block boundary.
+    void add_point();
+
+    // Start next gzip member; returns false at end of data.
+    bool next_member();
+
+    static constexpr std::size_t span = 1 << 20;
+    static constexpr std::size_t wsize = 32768;
+
+    File file;
+    z_stream strm;
+    bool raw = false;           // raw inflate after restart at point
+    bool finished = false;      // end of data
+    std::uint64_t in_pos = 0;   // compressed offset of input buffer end
+    unsigned char inbuf[1 << 16];
+
+    std::vector<Bytef> win = std::vector<Bytef>(wsize); // circular window
+    std::size_t wpos = 0;
+    std::uint64_t wlen = 0;
+
+    std::vector<Point> points;
+};
+
+constexpr std::size_t Gzip_decoder::span;
+constexpr std::size_t Gzip_decoder::wsize;
+
+bool Gzip_decoder::fill()
+{
+    std::size_t n = std::fread(inbuf, 1, sizeof(inbuf), file.get());
+    if (n == 0) {
+        if (std::ferror(file.get())) {
+            throw std::runtime_error("read error");
+        }
+        return false;
+    }
+    in_pos += n;
+    strm.next_in = inbuf;
+    strm.avail_in = static_cast<uInt>(n);
+    return true;
+}
+
+void Gzip_decoder::update_window(const char* buf, std::size_t n)
+{
+    if (n >= wsize) {
+        std::memcpy(win.data(), buf + n - wsize, wsize);
+        wpos = 0;
+    }
+    else {
+        std::size_t n1 = std::min(n, wsize - wpos);
+        std::memcpy(win.data() + wpos, buf, n1);
+        std::memcpy(win.data(), buf + n1, n - n1);
+        wpos = (wpos + n) % wsize;
+    }
+    wlen += n;
+}
+
+void Gzip_decoder::add_point()
+{
+    const bool at_block_end =
+        (strm.data_type & 128) != 0 && (strm.data_type & 64) == 0;
+    if (!at_block_end) {
+        return;
+    }
+    if (!points.empty() && out < points.back().out + span) {
+        return;
+    }
+    if (points.empty() && out > 0) {
+        return; // first point must be at beginning
+    }
+    Point p;
+    p.out = out;
+    p.in = in_pos - strm.avail_in;
+    p.bits = strm.data_type & 7;
+    const std::size_t n = static_cast<std::size_t>(
+        std::min<std::uint64_t>(wlen, wsize));
+    p.win.resize(n);
+    for (std::size_t i = 0; i < n; ++i) { // oldest byte first
+        p.win[i] = win[(wpos + wsize - n + i) % wsize];
+    }
+    points.push_back(std::move(p));
+}
+
+bool Gzip_decoder::next_member()
+{
+    if (raw) { // skip trailer of member; the next member has a header
+        for (int i = 0; i < 8; ++i) {
+            if (strm.avail_in == 0 && !fill()) {
+                return false;
+            }
+            ++strm.next_in;
+            --strm.avail_in;
+        }
+        inflateReset2(&strm, 31);
+        raw = false;
+    }
+    else {
+        inflateReset(&strm);
+    }
+    if (strm.avail_in == 0 && !fill()) {
+        return false;
+    }
+    return true;
+}
+
+std::size_t Gzip_decoder::read(char* buf, std::size_t n)
+{
+    std::size_t nout = 0;
+    bool member_start = false;
+    while (nout < n && !finished) {
+        if (strm.avail_in == 0 && !fill()) {
+            finished = true; // truncated file; return what we have
+            break;
+        }
+        auto dst = reinterpret_cast<Bytef*>(buf + nout);
+        strm.next_out = dst;
+        strm.avail_out = static_cast<uInt>(std::min<std::size_t>(
+            n - nout, std::numeric_limits<uInt>::max()));
+        int ret = inflate(&strm, Z_BLOCK);
+        const auto produced = static_cast<std::size_t>(strm.next_out - dst);
+        if (produced > 0) {
+            update_window(buf + nout, produced);
+            nout += produced;
+            out += produced;
+            member_start = false;
+        }
+        if (ret == Z_STREAM_END) {
+            if (!next_member()) {
+                finished = true;
+            }
+            member_start = true;
+            continue;
+        }
+        if (ret == Z_DATA_ERROR && member_start) {
+            finished = true; // trailing garbage after last member
+            break;
+        }
+        if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            throw std::runtime_error("corrupt gzip data");
+        }
+        add_point();
+    }
+    return nout;
+}
+
+bool Gzip_decoder::seek(std::uint64_t pos)
+{
+    // Use the last access point preceding pos if decompression would
+    // otherwise be restarted, or if it is further ahead:
+    auto it = std::upper_bound(
+        points.begin(), points.end(), pos,
+        [](std::uint64_t x, const Point& p) { return x < p.out; });
+    if (it != points.begin()) {
+        const Point& p = *(it - 1);
+        if (pos < out || p.out > out) {
+            inflateEnd(&strm);
+            std::memset(&strm, 0, sizeof(strm));
+            if (inflateInit2(&strm, -15) != Z_OK) {
+                throw std::runtime_error("inflateInit2 failed");
+            }
+            raw = true;
+            finished = false;
+            file_seek(file.get(), p.bits ? p.in - 1 : p.in);
+            in_pos = p.bits ? p.in - 1 : p.in;
+            if (p.bits) {
+                int ch = std::fgetc(file.get());
+                if (ch == EOF) {
+                    throw std::runtime_error("could not seek in gzip file");
+                }
+                ++in_pos;
+                inflatePrime(&strm, p.bits, ch >> (8 - p.bits));
+            }
+            if (!p.win.empty()) {
+                inflateSetDictionary(&strm, p.win.data(),
+                                     static_cast<uInt>(p.win.size()));
+            }
+            // Restore window for new access points:
+            std::copy(p.win.begin(), p.win.end(), win.begin());
+            wpos = p.win.size() % wsize;
+            wlen = p.win.size();
+            out = p.out;
+        }
+    }
+    else if (pos < out) {
+        reset();
+    }
+    return skip(pos);
+}
+
+void Gzip_decoder::reset()
+{
+    inflateEnd(&strm);
+    std::memset(&strm, 0, sizeof(strm));
+    if (inflateInit2(&strm, 47) != Z_OK) {
+        throw std::runtime_error("inflateInit2 failed");
+    }
+    file_seek(file.get(), 0);
+    raw = false;
+    finished = false;
+    in_pos = 0;
+    wpos = 0;
+    wlen = 0;
+    out = 0;
+}
+
+#endif // CHEMAPPS_HAVE_ZLIB
+
+//------------------------------------------------------------------------------
+
+#ifdef CHEMAPPS_HAVE_LZMA
+
+// Decoder for xz files, possibly concatenated.
+class Xz_decoder : public Decoder {
+public:
+    explicit Xz_decoder(const std::string& filename) : file(filename)
+    {
+        init();
+    }
+
+    ~Xz_decoder() override { lzma_end(&strm); }
+
+    std::size_t read(char* buf, std::size_t n) override
+    {
+        std::size_t nout = 0;
+        while (nout < n && !finished) {
+            lzma_action action = LZMA_RUN;
+            if (strm.avail_in == 0) {
+                std::size_t nin = std::fread(inbuf, 1, sizeof(inbuf), file.get());
+                if (nin == 0 && std::ferror(file.get())) {
+                    throw std::runtime_error("read error");
+                }
+                strm.next_in = inbuf;
+                strm.avail_in = nin;
+                if (nin == 0) {
+                    action = LZMA_FINISH;
+                }
+            }
+            auto dst = reinterpret_cast<std::uint8_t*>(buf + nout);
+            strm.next_out = dst;
+            strm.avail_out = n - nout;
+            lzma_ret ret = lzma_code(&strm, action);
+            const auto produced = static_cast<std::size_t>(strm.next_out - dst);
+            nout += produced;
+            out += produced;
+            if (ret == LZMA_STREAM_END) {
+                finished = true;
+            }
+            else if (ret != LZMA_OK) {
+                throw std::runtime_error("corrupt xz data");
+            }
+        }
+        return nout;
+    }
+
+protected:
+    void reset() override
+    {
+        lzma_end(&strm);
+        file_seek(file.get(), 0);
+        init();
+        out = 0;
+    }
+
+private:
+    void init()
+    {
+        strm = LZMA_STREAM_INIT;
+        if (lzma_stream_decoder(&strm, UINT64_MAX, LZMA_CONCATENATED) !=
+            LZMA_OK) {
+            throw std::runtime_error("lzma_stream_decoder failed");
+        }
+        finished = false;
+    }
+
+    File file;
+    lzma_stream strm;
+    bool finished;
+    std::uint8_t inbuf[1 << 16];
+};
+
+#endif // CHEMAPPS_HAVE_LZMA
+
+//------------------------------------------------------------------------------
+
+#ifdef CHEMAPPS_HAVE_ZSTD
+
+// Decoder for zstd files, possibly with several frames.
+class Zstd_decoder : public Decoder {
+public:
+    explicit Zstd_decoder(const std::string& filename)
+        : file(filename), dstream(ZSTD_createDStream())
+    {
+        if (!dstream) {
+            throw std::runtime_error("ZSTD_createDStream failed");
+        }
+        ZSTD_initDStream(dstream);
+    }
+
+    ~Zstd_decoder() override { ZSTD_freeDStream(dstream); }
+
+    std::size_t read(char* buf, std::size_t n) override
+    {
+        ZSTD_outBuffer ob = {buf, n, 0};
+        while (ob.pos < ob.size) {
+            if (input.pos == input.size) {
+                std::size_t nin = std::fread(inbuf, 1, sizeof(inbuf), file.get());
+                if (nin == 0) {
+                    if (std::ferror(file.get())) {
+                        throw std::runtime_error("read error");
+                    }
+                    break;
+                }
+                input = {inbuf, nin, 0};
+            }
+            std::size_t ret = ZSTD_decompressStream(dstream, &ob, &input);
+            if (ZSTD_isError(ret)) {
+                throw std::runtime_error("corrupt zstd data");
+            }
+        }
+        out += ob.pos;
+        return ob.pos;
+    }
+
+protected:
+    void reset() override
+    {
+        file_seek(file.get(), 0);
+        ZSTD_initDStream(dstream);
+        input = {inbuf, 0, 0};
+        out = 0;
+    }
+
+private:
+    File file;
+    ZSTD_DStream* dstream;
+    char inbuf[1 << 17];
+    ZSTD_inBuffer input = {inbuf, 0, 0};
+};
+
+#endif // CHEMAPPS_HAVE_ZSTD
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+Chem::Compression Chem::detect_compression(const unsigned char* magic,
+                                           std::size_t n)
+{
+    if (n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+        return Compression::gzip;
+    }
+    if (n >= 6 && std::memcmp(magic, "\xfd" "7zXZ\0", 6) == 0) {
+        return Compression::xz;
+    }
+    if (n >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f &&
+        magic[3] == 0xfd) {
+        return Compression::zstd;
+    }
+    return Compression::none;
+}
+
+Chem::Decompress_buf::Decompress_buf()
+    : format(Compression::none),
+      chunk_pos(0),
+      done(false),
+      halt(false),
+      error(nullptr)
+{
+}
+
+Chem::Decompress_buf::~Decompress_buf() { close(); }
+
+bool Chem::Decompress_buf::open(const std::string& filename)
+{
+    close();
+
+    unsigned char magic[6];
+    std::size_t n;
+    {
+        std::FILE* fp = std::fopen(filename.c_str(), "rb");
+        if (!fp) {
+            return false;
+        }
+        n = std::fread(magic, 1, sizeof(magic), fp);
+        std::fclose(fp);
+    }
+    format = detect_compression(magic, n);
+
+    switch (format) {
+    case Compression::none:
+        decoder.reset(new Plain_decoder(filename));
+        break;
+    case Compression::gzip:
+#ifdef CHEMAPPS_HAVE_ZLIB
+        decoder.reset(new Gzip_decoder(filename));
+        break;
+#else
+        throw std::runtime_error("gzip support not available: " + filename);
+#endif
+    case Compression::xz:
+#ifdef CHEMAPPS_HAVE_LZMA
+        decoder.reset(new Xz_decoder(filename));
+        break;
+#else
+        throw std::runtime_error("xz support not available: " + filename);
+#endif
+    case Compression::zstd:
+#ifdef CHEMAPPS_HAVE_ZSTD
+        decoder.reset(new Zstd_decoder(filename));
+        break;
+#else
+        throw std::runtime_error("zstd support not available: " + filename);
+#endif
+    }
+    chunk.clear();
+    chunk_pos = 0;
+    setg(chunk.data(), chunk.data(), chunk.data());
+    start();
+    return true;
+}
+
+void Chem::Decompress_buf::close()
+{
+    if (decoder) {
+        stop();
+        decoder.reset();
+    }
+    chunk.clear();
+    chunk_pos = 0;
+    setg(chunk.data(), chunk.data(), chunk.data());
+}
+
+Chem::Decompress_buf::int_type Chem::Decompress_buf::underflow()
+{
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    if (!decoder) {
+        return traits_type::eof();
+    }
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [&]() { return done || !queue.empty(); });
+    if (queue.empty()) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return traits_type::eof();
+    }
+    chunk_pos += chunk.size();
+    chunk = std::move(queue.front());
+    queue.pop_front();
+    lock.unlock();
+    cv.notify_all();
+
+    setg(chunk.data(), chunk.data(), chunk.data() + chunk.size());
+    return traits_type::to_int_type(*gptr());
+}
+
+Chem::Decompress_buf::pos_type Chem::Decompress_buf::seekoff(
+    off_type off, std::ios_base::seekdir way, std::ios_base::openmode which)
+{
+    const pos_type bad = pos_type(off_type(-1));
+    if (!decoder || !(which & std::ios_base::in)) {
+        return bad;
+    }
+    const auto cur =
+        static_cast<std::int64_t>(chunk_pos + (gptr() - eback()));
+    std::int64_t target;
+    if (way == std::ios_base::beg) {
+        target = off;
+    }
+    else if (way == std::ios_base::cur) {
+        if (off == 0) { // tellg
+            return pos_type(cur);
+        }
+        target = cur + off;
+    }
+    else {
+        return bad;
+    }
+    if (target < 0 || !restart(static_cast<std::uint64_t>(target))) {
+        return bad;
+    }
+    return pos_type(target);
+}
+
+Chem::Decompress_buf::pos_type
+Chem::Decompress_buf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+//------------------------------------------------------------------------------
+
+void Chem::Decompress_buf::start()
+{
+    done = false;
+    halt = false;
+    error = nullptr;
+    worker = std::thread([this]() {
+        try {
+            while (true) {
+                std::vector<char> buf(chunk_size);
+                buf.resize(decoder->read(buf.data(), buf.size()));
+
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&]() { return halt || queue.size() < read_ahead; });
+                if (halt) {
+                    break;
+                }
+                if (buf.empty()) {
+                    done = true;
+                    cv.notify_all();
+                    break;
+                }
+                queue.push_back(std::move(buf));
+                cv.notify_all();
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mtx);
+            error = std::current_exception();
+            done = true;
+            cv.notify_all();
+        }
+    });
+}
+
+void Chem::Decompress_buf::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        halt = true;
+    }
+    cv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    queue.clear();
+}
+
+bool Chem::Decompress_buf::restart(std::uint64_t pos)
+{
+    // Seek within current chunk:
+    if (pos >= chunk_pos && pos <= chunk_pos + chunk.size()) {
+        setg(eback(), eback() + (pos - chunk_pos), egptr());
+        return true;
+    }
+
+    // Seek within chunks already queued:
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::uint64_t first = chunk_pos + chunk.size();
+        while (!queue.empty() && pos >= first + queue.front().size()) {
+            first += queue.front().size();
+            queue.pop_front();
+        }
+        if (!queue.empty() && pos >= first) {
+            chunk = std::move(queue.front());
+            queue.pop_front();
+            chunk_pos = first;
+            setg(chunk.data(), chunk.data() + (pos - first),
+                 chunk.data() + chunk.size());
+            cv.notify_all();
+            return true;
+        }
+    }
+
+    // Restart decompression:
+    stop();
+    chunk.clear();
+    setg(chunk.data(), chunk.data(), chunk.data());
+    bool ok = decoder->seek(pos);
+    chunk_pos = pos;
+    start();
+    return ok;
+}
@@ -0,0 +1,542 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/forcefield.h>
+#include <numlib/constants.h>
+#include <stdutils/stdutils.h>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+namespace {
+
+// Parameters of an atom type.
+struct Atom_param {
+    double rcov; // covalent radius (Angstrom)
+    double x;    // UFF Lennard-Jones distance (Angstrom)
+    double d;    // UFF Lennard-Jones well depth (kcal/mol)
+};
+
+Atom_param get_atom_param(int atomic_number)
+{
+    switch (atomic_number) {
+    case 1:
+        return {0.31, 2.886, 0.044};
+    case 6:
+        return {0.76, 3.851, 0.105};
+    case 7:
+        return {0.71, 3.660, 0.069};
+    case 8:
+        return {0.66, 3.500, 0.060};
+    case 9:
+        return {0.57, 3.364, 0.050};
+    case 14:
+        return {1.11, 4.295, 0.402};
+    case 15:
+        return {1.07, 4.147, 0.305};
+    case 16:
+        return {1.05, 4.035, 0.274};
+    case 17:
+        return {1.02, 3.947, 0.227};
+    case 35:
+        return {1.20, 4.189, 0.251};
+    case 53:
+        return {1.39, 4.500, 0.339};
+    default:
+        return {1.50, 4.000, 0.100};
+    }
+}
+
+// Get reference angle (degrees) for central atom with given coordination.
+double get_ref_angle(int atomic_number, std::size_t coord)
+{
+    if (coord >= 4) {
+        return 109.47;
+    }
+    else if (coord == 3) {
+        if (atomic_number == 7 || atomic_number == 15) {
+            return 107.0;
+        }
+        return 120.0;
+    }
+    else {
+        if (atomic_number == 8 || atomic_number == 16) {
+            return 104.5;
+        }
+        return 180.0;
+    }
+}
+
+// Tolerance on the sum of covalent radii for perceiving bonds.
+constexpr double bond_tol = 1.2;
+
+inline double dot(const double* a, const double* b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+inline void cross(const double* a, const double* b, double* c)
+{
+    c[0] = a[1] * b[2] - a[2] * b[1];
+    c[1] = a[2] * b[0] - a[0] * b[2];
+    c[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+inline void diff(const double* a, const double* b, double* c)
+{
+    c[0] = a[0] - b[0];
+    c[1] = a[1] - b[1];
+    c[2] = a[2] - b[2];
+}
+
+} // namespace
+
+void Chem::Forcefield::init(std::istream& from, const std::string& key)
+{
+    // Read input data:
+
+    using namespace Stdutils;
+
+    auto pos = find_token(from, key);
+    if (pos != -1) {
+        get_token_value(from, pos, "k_bond", k_bond, 1400.0);
+        get_token_value(from, pos, "k_angle", k_angle, 400.0);
+        get_token_value(from, pos, "v_tors", v_tors, 6.0);
+        get_token_value(from, pos, "scale14", scale14, 0.5);
+        get_token_value(from, pos, "dielectric", dielectric, 1.0);
+        get_token_value(from, pos, "gtol", gtol, 1.0e-3);
+        get_token_value(from, pos, "maxiter", maxiter, 1000);
+        get_token_value(from, pos, "lbfgs_memory", nhist, 8);
+        pos = find_token(from, "charges", pos);
+        if (pos != -1) {
+            from >> charges;
+        }
+    }
+    Assert::dynamic(k_bond >= 0.0, "bad k_bond");
+    Assert::dynamic(k_angle >= 0.0, "bad k_angle");
+    Assert::dynamic(dielectric > 0.0, "bad dielectric");
+    Assert::dynamic(gtol > 0.0, "bad gtol");
+    Assert::dynamic(maxiter > 0, "bad maxiter");
+    Assert::dynamic(nhist > 0, "bad lbfgs_memory");
+}
+
+void Chem::Forcefield::run(Chem::Molecule& mol) const
+{
+    const Topology top = set_topology(mol);
+
+    Numlib::Mat<double> xyz = mol.get_xyz();
+    std::vector<double> x(xyz.data(), xyz.data() + xyz.size());
+
+    double e = 0.0;
+    if (lbfgs(top, x, e)) {
+        std::copy(x.begin(), x.end(), xyz.data());
+        mol.set_xyz(xyz); // update Cartesian coordinates
+        mol.elec().set_energy(e); // update energy
+    }
+    else { // optimization failed to converge; set energy to infinity
+        mol.elec().set_energy(std::numeric_limits<double>::infinity());
+    }
+}
+
+void Chem::Forcefield::run_batch(std::vector<Chem::Molecule>& mols) const
+{
+    const auto n = static_cast<long>(mols.size());
+#pragma omp parallel for schedule(dynamic)
+    for (long i = 0; i < n; ++i) {
+        run(mols[i]);
+    }
+}
+
+double Chem::Forcefield::energy(const Chem::Molecule& mol) const
+{
+    const Topology top = set_topology(mol);
+
+    const auto& xyz = mol.get_xyz();
+    std::vector<double> x(xyz.data(), xyz.data() + xyz.size());
+    std::vector<double> g(x.size());
+    return energy_grad(top, x, g);
+}
+
+//------------------------------------------------------------------------------
+
+Chem::Forcefield::Topology
+Chem::Forcefield::set_topology(const Chem::Molecule& mol) const
+{
+    const auto& atoms = mol.atoms();
+    const std::size_t natoms = atoms.size();
+
+    Assert::dynamic(charges.empty() ||
+                        charges.size() == narrow_cast<Index>(natoms),
+                    "bad number of charges");
+
+    Topology top;
+
+    // Bonds are perceived from interatomic distances; atoms closer than
+    // bond_tol times the sum of their covalent radii are bonded:
+    const auto& xyz = mol.get_xyz();
+    std::vector<std::vector<Index>> adj(natoms);
+    for (std::size_t i = 0; i < natoms; ++i) {
+        double ri = get_atom_param(atoms[i].atomic_number).rcov;
+        for (std::size_t j = i + 1; j < natoms; ++j) {
+            double rj = get_atom_param(atoms[j].atomic_number).rcov;
+            double u[3];
+            for (Index c = 0; c < 3; ++c) {
+                u[c] = xyz(narrow_cast<Index>(j), c) -
+                       xyz(narrow_cast<Index>(i), c);
+            }
+            if (std::sqrt(dot(u, u)) < bond_tol * (ri + rj)) {
+                Index ii = narrow_cast<Index>(i);
+                Index jj = narrow_cast<Index>(j);
+                top.bonds.push_back({ii, jj});
+                adj[i].push_back(jj);
+                adj[j].push_back(ii);
+                top.r0.push_back(ri + rj);
+            }
+        }
+    }
+
+    // Angle bends:
+    for (std::size_t j = 0; j < natoms; ++j) {
+        double theta0 =
+            get_ref_angle(atoms[j].atomic_number, adj[j].size()) *
+            Numlib::Constants::pi / 180.0;
+        for (std::size_t a = 0; a < adj[j].size(); ++a) {
+            for (std::size_t b = a + 1; b < adj[j].size(); ++b) {
+                top.angles.push_back(
+                    {adj[j][a], narrow_cast<Index>(j), adj[j][b]});
+                top.cos0.push_back(std::cos(theta0));
+            }
+        }
+    }
+
+    // Torsions about each bond, with the barrier shared among all
+    // torsions about the bond:
+    for (const auto& bd : top.bonds) {
+        Index j = bd[0];
+        Index k = bd[1];
+        std::size_t ntors = (adj[j].size() - 1) * (adj[k].size() - 1);
+        if (ntors == 0) {
+            continue;
+        }
+        int n = 3; // sp3-sp3
+        if (adj[j].size() == 3 && adj[k].size() == 3) {
+            n = 2; // sp2-sp2
+        }
+        for (auto i : adj[j]) {
+            if (i == k) {
+                continue;
+            }
+            for (auto l : adj[k]) {
+                if (l == j) {
+                    continue;
+                }
+                top.torsions.push_back({i, j, k, l});
+                top.vtors.push_back(v_tors / static_cast<double>(ntors));
+                top.ntors.push_back(n);
+            }
+        }
+    }
+
+    // Non-bonded pairs separated by more than two bonds; 1-4 pairs are
+    // scaled:
+    const double sixth_root_two = std::pow(2.0, 1.0 / 6.0);
+    const double coulomb = 1389.35458 / dielectric; // kJ/mol Angstrom/e^2
+
+    std::vector<int> nbonds(natoms);
+    for (std::size_t i = 0; i < natoms; ++i) {
+        // Find topological distances from atom i:
+        std::fill(nbonds.begin(), nbonds.end(), -1);
+        std::deque<std::size_t> queue = {i};
+        nbonds[i] = 0;
+        while (!queue.empty()) {
+            auto a = queue.front();
+            queue.pop_front();
+            if (nbonds[a] == 3) {
+                continue;
+            }
+            for (auto b : adj[a]) {
+                if (nbonds[b] == -1) {
+                    nbonds[b] = nbonds[a] + 1;
+                    queue.push_back(b);
+                }
+            }
+        }
+        auto pi = get_atom_param(atoms[i].atomic_number);
+        for (std::size_t j = i + 1; j < natoms; ++j) {
+            if (nbonds[j] == 1 || nbonds[j] == 2) {
+                continue;
+            }
+            double scale = (nbonds[j] == 3) ? scale14 : 1.0;
+            auto pj = get_atom_param(atoms[j].atomic_number);
+            top.pairs.push_back(
+                {narrow_cast<Index>(i), narrow_cast<Index>(j)});
+            top.sigma.push_back(0.5 * (pi.x + pj.x) / sixth_root_two);
+            top.eps.push_back(scale * std::sqrt(pi.d * pj.d) *
+                          Numlib::Constants::cal_to_J);
+            double qq = 0.0;
+            if (!charges.empty()) {
+                qq = scale * coulomb * charges(i) * charges(j);
+            }
+            top.qq.push_back(qq);
+        }
+    }
+    return top;
+}
+
+double Chem::Forcefield::energy_grad(const Topology& top,
+                                     const std::vector<double>& x,
+                                     std::vector<double>& g) const
+{
+    std::fill(g.begin(), g.end(), 0.0);
+    double e = 0.0;
+
+    // Bond stretches:
+    for (std::size_t b = 0; b < top.bonds.size(); ++b) {
+        const double* xi = &x[3 * top.bonds[b][0]];
+        const double* xj = &x[3 * top.bonds[b][1]];
+        double* gi = &g[3 * top.bonds[b][0]];
+        double* gj = &g[3 * top.bonds[b][1]];
+        double u[3];
+        diff(xj, xi, u);
+        double r = std::sqrt(dot(u, u));
+        double dr = r - top.r0[b];
+        e += k_bond * dr * dr;
+        double f = 2.0 * k_bond * dr / r;
+        for (int c = 0; c < 3; ++c) {
+            gi[c] -= f * u[c];
+            gj[c] += f * u[c];
+        }
+    }
+
+    // Angle bends:
+    for (std::size_t a = 0; a < top.angles.size(); ++a) {
+        const double* xi = &x[3 * top.angles[a][0]];
+        const double* xj = &x[3 * top.angles[a][1]];
+        const double* xk = &x[3 * top.angles[a][2]];
+        double* gi = &g[3 * top.angles[a][0]];
+        double* gj = &g[3 * top.angles[a][1]];
+        double* gk = &g[3 * top.angles[a][2]];
+        double u[3];
+        double v[3];
+        diff(xi, xj, u);
+        diff(xk, xj, v);
+        double ru = std::sqrt(dot(u, u));
+        double rv = std::sqrt(dot(v, v));
+        double cost = dot(u, v) / (ru * rv);
+        double dc = cost - top.cos0[a];
+        e += k_angle * dc * dc;
+        double f = 2.0 * k_angle * dc;
+        for (int c = 0; c < 3; ++c) {
+            double dci = v[c] / (ru * rv) - cost * u[c] / (ru * ru);
+            double dck = u[c] / (ru * rv) - cost * v[c] / (rv * rv);
+            gi[c] += f * dci;
+            gk[c] += f * dck;
+            gj[c] -= f * (dci + dck);
+        }
+    }
+
+    // Torsions:
+    for (std::size_t t = 0; t < top.torsions.size(); ++t) {
+        const double* x1 = &x[3 * top.torsions[t][0]];
+        const double* x2 = &x[3 * top.torsions[t][1]];
+        const double* x3 = &x[3 * top.torsions[t][2]];
+        const double* x4 = &x[3 * top.torsions[t][3]];
+        double fv[3];
+        double gv[3];
+        double hv[3];
+        diff(x1, x2, fv);
+        diff(x2, x3, gv);
+        diff(x4, x3, hv);
+        double av[3];
+        double bv[3];
+        cross(fv, gv, av);
+        cross(hv, gv, bv);
+        double a2 = dot(av, av);
+        double b2 = dot(bv, bv);
+        double rg = std::sqrt(dot(gv, gv));
+        if (a2 < 1.0e-12 || b2 < 1.0e-12 || rg < 1.0e-12) {
+            continue; // linear arrangement; torsion is undefined
+        }
+        double cv[3];
+        cross(bv, av, cv);
+        double phi = std::atan2(dot(cv, gv) / rg, dot(av, bv));
+
+        // E = V/2 (1 + cos(3 phi)) for sp3 and V/2 (1 - cos(2 phi)) for sp2:
+        const double n = top.ntors[t];
+        const double sign = (top.ntors[t] == 3) ? 1.0 : -1.0;
+        e += 0.5 * top.vtors[t] * (1.0 + sign * std::cos(n * phi));
+        double f = -0.5 * top.vtors[t] * sign * n * std::sin(n * phi);
+
+        double fg = dot(fv, gv);
+        double hg = dot(hv, gv);
+        for (int c = 0; c < 3; ++c) {
+            double d1 = -rg / a2 * av[c];
+            double d4 = rg / b2 * bv[c];
+            double da = fg / (a2 * rg) * av[c];
+            double db = hg / (b2 * rg) * bv[c];
+            g[3 * top.torsions[t][0] + c] += f * d1;
+            g[3 * top.torsions[t][1] + c] += f * (-d1 + da - db);
+            g[3 * top.torsions[t][2] + c] += f * (db - da - d4);
+            g[3 * top.torsions[t][3] + c] += f * d4;
+        }
+    }
+
+    // Non-bonded interactions:
+    for (std::size_t p = 0; p < top.pairs.size(); ++p) {
+        const double* xi = &x[3 * top.pairs[p][0]];
+        const double* xj = &x[3 * top.pairs[p][1]];
+        double* gi = &g[3 * top.pairs[p][0]];
+        double* gj = &g[3 * top.pairs[p][1]];
+        double u[3];
+        diff(xj, xi, u);
+        double r2 = dot(u, u);
+        double r = std::sqrt(r2);
+        double sr2 = top.sigma[p] * top.sigma[p] / r2;
+        double sr6 = sr2 * sr2 * sr2;
+        double sr12 = sr6 * sr6;
+        e += 4.0 * top.eps[p] * (sr12 - sr6) + top.qq[p] / r;
+        // (dE/dr) / r:
+        double f = (-24.0 * top.eps[p] * (2.0 * sr12 - sr6) - top.qq[p] / r) /
+                   r2;
+        for (int c = 0; c < 3; ++c) {
+            gi[c] -= f * u[c];
+            gj[c] += f * u[c];
+        }
+    }
+    return e;
+}
+
+bool Chem::Forcefield::lbfgs(const Topology& top,
+                             std::vector<double>& x,
+                             double& e) const
+{
+    const std::size_t n = x.size();
+    if (n == 0) {
+        e = 0.0;
+        return true;
+    }
+
+    auto vdot = [](const std::vector<double>& a, const std::vector<double>& b) {
+        double res = 0.0;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            res += a[i] * b[i];
+        }
+        return res;
+    };
+
+    const std::size_t m = narrow_cast<std::size_t>(nhist);
+    std::deque<std::vector<double>> s_hist;
+    std::deque<std::vector<double>> y_hist;
+    std::deque<double> rho_hist;
+    std::vector<double> alpha(m);
+
+    std::vector<double> g(n);
+    std::vector<double> d(n);
+    std::vector<double> x_new(n);
+    std::vector<double> g_new(n);
+
+    e = energy_grad(top, x, g);
+
+    const double max_step = 0.3; // max displacement of one coordinate
+    const double c1 = 1.0e-4;    // Armijo condition
+
+    for (int iter = 0; iter < maxiter; ++iter) {
+        if (!std::isfinite(e)) {
+            return false;
+        }
+        if (std::sqrt(vdot(g, g) / static_cast<double>(n)) < gtol) {
+            return true;
+        }
+
+        // Two-loop recursion for the search direction:
+        d = g;
+        for (std::size_t k = s_hist.size(); k-- > 0;) {
+            alpha[k] = rho_hist[k] * vdot(s_hist[k], d);
+            for (std::size_t i = 0; i < n; ++i) {
+                d[i] -= alpha[k] * y_hist[k][i];
+            }
+        }
+        if (!s_hist.empty()) {
+            double gamma = vdot(s_hist.back(), y_hist.back()) /
+                           vdot(y_hist.back(), y_hist.back());
+            for (auto& di : d) {
+                di *= gamma;
+            }
+        }
+        for (std::size_t k = 0; k < s_hist.size(); ++k) {
+            double beta = rho_hist[k] * vdot(y_hist[k], d);
+            for (std::size_t i = 0; i < n; ++i) {
+                d[i] += (alpha[k] - beta) * s_hist[k][i];
+            }
+        }
+        for (auto& di : d) {
+            di = -di;
+        }
+
+        double slope = vdot(g, d);
+        if (slope >= 0.0) { // not a descent direction; restart
+            s_hist.clear();
+            y_hist.clear();
+            rho_hist.clear();
+            for (std::size_t i = 0; i < n; ++i) {
+                d[i] = -g[i];
+            }
+            slope = vdot(g, d);
+        }
+
+        // Limit the step length:
+        double dmax = 0.0;
+        for (auto di : d) {
+            dmax = std::max(dmax, std::abs(di));
+        }
+        double step = 1.0;
+        if (dmax * step > max_step) {
+            step = max_step / dmax;
+        }
+
+        // Backtracking line search:
+        double e_new = 0.0;
+        bool accepted = false;
+        for (int ls = 0; ls < 30; ++ls) {
+            for (std::size_t i = 0; i < n; ++i) {
+                x_new[i] = x[i] + step * d[i];
+            }
+            e_new = energy_grad(top, x_new, g_new);
+            if (std::isfinite(e_new) && e_new <= e + c1 * step * slope) {
+                accepted = true;
+                break;
+            }
+            step *= 0.5;
+        }
+        if (!accepted) {
+            return false;
+        }
+
+        // Update correction pairs:
+        std::vector<double> s(n);
+        std::vector<double> y(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            s[i] = x_new[i] - x[i];
+            y[i] = g_new[i] - g[i];
+        }
+        double sy = vdot(s, y);
+        if (sy > 1.0e-10) {
+            if (s_hist.size() == m) {
+                s_hist.pop_front();
+                y_hist.pop_front();
+                rho_hist.pop_front();
+            }
+            s_hist.push_back(std::move(s));
+            y_hist.push_back(std::move(y));
+            rho_hist.push_back(1.0 / sy);
+        }
+        x.swap(x_new);
+        g.swap(g_new);
+        e = e_new;
+    }
+    return std::sqrt(vdot(g, g) / static_cast<double>(n)) < gtol;
+}
@@ -5,6 +5,8 @@
 // and conditions.
 
 #include <chem/gamcs.h>
+#include <chem/cascade.h>
+#include <chem/forcefield.h>
 #include <chem/gaussian.h>
 #include <chem/mopac.h>
 #include <chem/io.h>
@@ -26,7 +28,7 @@ Chem::Gamcs<Pot>::Gamcs(std::istream& from, std::ostream& to) : mol(from, to)
     dist_max = 2.2;
 
     energy_min = -std::numeric_limits<double>::max();
-    energy_max = 0.0;
+    energy_max = energy_max_default<Pot>();
     energy_var = 1.0e-3;
     energy_tol = 1.0e-3;
     ediff_global = 0.0;
@@ -111,6 +113,8 @@ Chem::Gamcs<Pot>::Gamcs(std::istream& from, std::ostream& to) : mol(from, to)
 
     // Initialize population:
 
+    population = Chem::Conformer_arena(mol.atoms());
+    blacklist = Chem::Conformer_arena(mol.atoms());
     init_population(to);
 }
 
@@ -159,30 +163,26 @@ void Chem::Gamcs<Pot>::solve(std::ostream& to)
             mutate(child1);
             mutate(child2);
         }
-        blacklist.push_back(
-            Chem::Conformer(child1.elec().energy(), child1.get_xyz()));
-        blacklist.push_back(
-            Chem::Conformer(child2.elec().energy(), child2.get_xyz()));
+        blacklist.push_back(child1.elec().energy(), child1.get_xyz());
+        blacklist.push_back(child2.elec().energy(), child2.get_xyz());
 
-        // Perform local optimization:
-        pot.run(child1);
-        pot.run(child2);
+        // Perform local optimization of both children in one batch:
+        std::vector<Chem::Molecule> children = {child1, child2};
+        pot.run_batch(children);
+        child1 = children[0];
+        child2 = children[1];
 
         // Update blacklist:
-        blacklist.push_back(
-            Chem::Conformer(child1.elec().energy(), child1.get_xyz()));
-        blacklist.push_back(
-            Chem::Conformer(child2.elec().energy(), child2.get_xyz()));
+        blacklist.push_back(child1.elec().energy(), child1.get_xyz());
+        blacklist.push_back(child2.elec().energy(), child2.get_xyz());
 
         // Update population if energies are sensible:
         if (child1.elec().energy() >= energy_min &&
             child1.elec().energy() < energy_max &&
             child2.elec().energy() >= energy_min &&
             child2.elec().energy() < energy_max) {
-            population.push_back(
-                Chem::Conformer(child1.elec().energy(), child1.get_xyz()));
-            population.push_back(
-                Chem::Conformer(child2.elec().energy(), child2.get_xyz()));
+            population.push_back(child1.elec().energy(), child1.get_xyz());
+            population.push_back(child2.elec().energy(), child2.get_xyz());
 
             sort_population();
 
@@ -190,7 +190,7 @@ void Chem::Gamcs<Pot>::solve(std::ostream& to)
             population.pop_back();
 
             compute_fitness();
-            min_energy.push_back(population[0].energy); // update energy log
+            min_energy.push_back(population.energy(0)); // update energy log
 
             status = "success";
             ++nsuccess;
@@ -203,7 +203,7 @@ void Chem::Gamcs<Pot>::solve(std::ostream& to)
         if (energy_converged(iter)) {
             converged = true;
         }
-        to << ifix(iter + 1) << "  " << dfix(population[0].energy) << "  "
+        to << ifix(iter + 1) << "  " << dfix(population.energy(0)) << "  "
            << sci(ediff_global) << "  " << sci(energy_var) << "  " << status
            << std::endl;
 
@@ -256,7 +256,7 @@ void Chem::Gamcs<Pot>::init_population(std::ostream& to)
         }
 
         // Add starting structure for local optimization to blacklist:
-        blacklist.push_back(Chem::Conformer(m.elec().energy(), m.get_xyz()));
+        blacklist.push_back(m.elec().energy(), m.get_xyz());
 
         // Perform local optimization:
         pot.run(m);
@@ -264,10 +264,8 @@ void Chem::Gamcs<Pot>::init_population(std::ostream& to)
 
         if (m.elec().energy() >= energy_min && m.elec().energy() < energy_max) {
             // Add optimized structure to blacklist and population:
-            blacklist.push_back(
-                Chem::Conformer(m.elec().energy(), m.get_xyz()));
-            population.push_back(
-                Chem::Conformer(m.elec().energy(), m.get_xyz()));
+            blacklist.push_back(m.elec().energy(), m.get_xyz());
+            population.push_back(m.elec().energy(), m.get_xyz());
             if (ecurr < ebest) {
                 ebest = ecurr;
             }
@@ -290,7 +288,7 @@ void Chem::Gamcs<Pot>::init_population(std::ostream& to)
 
     sort_population();
     compute_fitness();
-    estart = population[0].energy; // save initial energy of global minimum
+    estart = population.energy(0); // save initial energy of global minimum
 
     line.width(19).fill('-');
     to << "Initial population:\n" << line('-') << '\n';
@@ -359,14 +357,7 @@ bool Chem::Gamcs<Pot>::geom_sensible(const Chem::Molecule& m) const
 template <class Pot>
 bool Chem::Gamcs<Pot>::is_blacklisted(const Numlib::Mat<double>& xyz) const
 {
-    bool res = false;
-    for (const auto& conformer : blacklist) {
-        if (Numlib::kabsch_rmsd(conformer.xyz, xyz) < xyz_rmsd) {
-            res = true;
-            break;
-        }
-    }
-    return res;
+    return blacklist.contains(xyz, xyz_rmsd);
 }
 
 template <class Pot>
@@ -374,17 +365,17 @@ void Chem::Gamcs<Pot>::compute_fitness()
 {
     fitness.clear();
 
-    double emin = population[0].energy;
-    double emax = population.end()[-1].energy;
+    double emin = population.energy(0);
+    double emax = population.energy(population.size() - 1);
     double ediff = std::abs(emax - emin);
 
     double fi = 0.0;
-    for (const auto& p : population) {
+    for (std::size_t i = 0; i < population.size(); ++i) {
         if (ediff < energy_var) {
             fi = 1.0;
         }
         else {
-            fi = (emax - p.energy) / ediff;
+            fi = (emax - population.energy(i)) / ediff;
         }
         fitness.push_back(fi);
     }
@@ -552,8 +543,8 @@ void Chem::Gamcs<Pot>::print_population(std::ostream& to) const
 
     for (std::size_t i = 0; i < population.size(); ++i) {
         to << "Conformer: " << i + 1 << '\n'
-           << "Energy: " << fix(population[i].energy) << '\n';
-        Chem::print_geometry(to, mol.atoms(), population[i].xyz);
+           << "Energy: " << fix(population.energy(i)) << '\n';
+        Chem::print_geometry(to, mol.atoms(), population.get_xyz(i));
         to << std::endl;
     }
 }
@@ -570,10 +561,14 @@ void Chem::Gamcs<Pot>::print_global_minimum(std::ostream& to) const
     to << "Estimated global minimum:\n"
        << line('-') << '\n'
        << "E(start): " << fix(estart) << '\n'
-       << "E(final): " << fix(population[0].energy) << '\n';
-    Chem::print_geometry(to, mol.atoms(), population[0].xyz);
+       << "E(final): " << fix(population.energy(0)) << '\n';
+    Chem::print_geometry(to, mol.atoms(), population.get_xyz(0));
     to << std::endl;
 }
 
 template class Chem::Gamcs<Chem::Gaussian>;
 template class Chem::Gamcs<Chem::Mopac>;
+template class Chem::Gamcs<Chem::Forcefield>;
+template class Chem::Gamcs<Chem::Cascade<Chem::Forcefield, Chem::Gaussian>>;
+template class Chem::Gamcs<Chem::Cascade<Chem::Forcefield, Chem::Mopac>>;
+template class Chem::Gamcs<Chem::Cascade<Chem::Mopac, Chem::Gaussian>>;
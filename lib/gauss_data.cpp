@@ -5,47 +5,121 @@
 // and conditions.
 
 #include <chem/gauss_data.h>
+#include <chem/mapped_file.h>
 #include <chem/periodic_table.h>
 #include <numlib/traits.h>
 #include <stdutils/stdutils.h>
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
+namespace {
+
+// Check if first token of line is equal to word.
+bool first_token_is(const std::string& line, const std::string& word)
+{
+    auto pos = line.find_first_not_of(" \t");
+    if (pos == std::string::npos || line.compare(pos, word.size(), word) != 0) {
+        return false;
+    }
+    pos += word.size();
+    return pos == line.size() || line[pos] == ' ' || line[pos] == '\t' ||
+           line[pos] == '\r';
+}
+
+// Find last offset before pos.
+bool last_before(const std::vector<std::streamoff>& offsets,
+                 std::streamoff pos,
+                 std::streamoff& res)
+{
+    auto it = std::lower_bound(offsets.begin(), offsets.end(), pos);
+    if (it == offsets.begin()) {
+        return false;
+    }
+    res = *(it - 1);
+    return true;
+}
+
+// Get number of elements from header line of fchk array ("... N=  n").
+int fchk_array_size(const std::string& header)
+{
+    auto pos = header.find("N=");
+    long n = 0;
+    if (pos == std::string::npos ||
+        !Chem::parse_int(Chem::Text_view(header.data(), header.size()).substr(pos + 2), n)) {
+        return 0;
+    }
+    return static_cast<int>(n);
+}
+
+bool parse_fchk_value(const char*& p, const char* end, double& x)
+{
+    return Chem::parse_double(p, end, x);
+}
+
+bool parse_fchk_value(const char*& p, const char* end, int& x)
+{
+    long n;
+    if (!Chem::parse_int(p, end, n)) {
+        return false;
+    }
+    x = static_cast<int>(n);
+    return true;
+}
+
+// Read n elements of fchk array following the header line. Reals are
+// written in 5E16.8 format and integers in 6I12 format; each field has at
+// least one leading blank, hence the values on a line are parsed in turn
+// without splitting the line into fields.
+template <class T>
+bool read_fchk_array(std::istream& from, T* x, int n)
+{
+    std::string line;
+    int i = 0;
+    while (i < n && std::getline(from, line)) {
+        const char* p = line.data();
+        const char* end = p + line.size();
+        while (i < n && parse_fchk_value(p, end, x[i])) {
+            ++i;
+        }
+    }
+    return i == n;
+}
+
+} // namespace
+
 Chem::Gauss_version Chem::Gauss_data::get_version() const
 {
-    const std::string pattern_start = "Cite this work as:";
     const std::string pattern_ver = "Gaussian";
 
     std::streampos orig_pos = from.tellg();
 
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-    from.clear();
-
     Gauss_version version = unknown;
 
     std::string line;
     std::string word;
     std::string ver;
 
-    while (std::getline(from, line)) {
-        if (line.find(pattern_start, 0) != std::string::npos) {
-            std::getline(from, line);
-            std::istringstream iss(line);
-            iss >> word >> ver;
-            if (word == pattern_ver) {
-                if (ver == "94,") {
-                    version = g94;
-                }
-                else if (ver == "98,") {
-                    version = g98;
-                }
-                else if (ver == "03,") {
-                    version = g03;
-                }
-                else if (ver == "09,") {
-                    version = g09;
-                }
+    for (auto pos : section(sec_cite)) {
+        seek(pos);
+        std::getline(from, line); // pattern_start
+        std::getline(from, line);
+        std::istringstream iss(line);
+        iss >> word >> ver;
+        if (word == pattern_ver) {
+            if (ver == "94,") {
+                version = g94;
+            }
+            else if (ver == "98,") {
+                version = g98;
+            }
+            else if (ver == "03,") {
+                version = g03;
+            }
+            else if (ver == "09,") {
+                version = g09;
             }
         }
     }
@@ -61,110 +135,60 @@ Chem::Gauss_version Chem::Gauss_data::get_version() const
 
 bool Chem::Gauss_data::check_termination() const
 {
-    std::streampos orig_pos = from.tellg();
-
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-    from.clear();
-
-    bool ok = true;
-    if (filetype == out) {
-        std::string line;
-        while (std::getline(from, line)) {
-            if (line.find("Error termination") != std::string::npos) {
-                ok = false;
-                break;
-            }
-        }
-    }
-    else {
+    if (filetype != out) {
         throw std::runtime_error("not implemented for fchk files");
     }
-    from.clear();
-    from.seekg(orig_pos, std::ios_base::beg); // move to original position
-    from.clear();
-
-    return ok;
+    return section(sec_error).empty();
 }
 
 bool Chem::Gauss_data::check_opt_conv() const
 {
-    std::streampos orig_pos = from.tellg();
-
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-    from.clear();
-
-    std::string line;
-    bool conv = false;
-    if (filetype == out) {
-        while (std::getline(from, line)) {
-            if (line.find("Stationary point found.") != std::string::npos) {
-                conv = true;
-                break;
-            }
-        }
-    }
-    else { // filetype == fchk
+    if (filetype != out) {
         throw std::runtime_error("not implemented for fchk files");
     }
-    from.clear();
-    from.seekg(orig_pos, std::ios_base::beg); // move to original position
-    from.clear();
-
-    return conv;
+    return !section(sec_stationary).empty();
 }
 
 int Chem::Gauss_data::get_natoms() const
 {
     std::streampos orig_pos = from.tellg();
 
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-    from.clear();
-
     int natoms = 0;
 
     if (filetype == out) {
-        const std::string pattern_start = "Input";
-        const std::string pattern_end = "Distance";
+        // Read input orientations preceding the first distance matrix:
+        const auto& dist = section(sec_distance);
 
         std::string line;
-        std::string token;
-
-        while (std::getline(from, line)) {
-            std::istringstream iss1(line);
-            iss1 >> token;
-            if (token == pattern_start) {
-                for (int i = 0; i < 4; ++i) { // ignore four lines
-                    from.ignore(256, '\n');
-                }
-                while (std::getline(from, line)) {
-                    std::istringstream iss2(line);
-                    if (line[1] == '-') {
-                        break;
-                    }
-                    iss2 >> natoms;
-                }
-            }
-            else if (token == pattern_end) {
+        for (auto pos : section(sec_input)) {
+            if (!dist.empty() && pos > dist.front()) {
                 break;
             }
+            seek(pos);
+            for (int i = 0; i < 5; ++i) { // ignore pattern and four lines
+                from.ignore(256, '\n');
+            }
+            while (std::getline(from, line)) {
+                std::istringstream iss(line);
+                if (line[1] == '-') {
+                    break;
+                }
+                iss >> natoms;
+            }
         }
     }
     else { // filetype == fchk
         const std::string pattern = "Number of atoms";
 
-        std::string line;
-        while (std::getline(from, line)) {
-            std::string::size_type pos = line.find(pattern);
-            if (pos != std::string::npos) {
-                std::istringstream iss(line);
-                char ignore;
-                iss.ignore(pattern.length(), '\n');
-                iss >> ignore >> natoms;
-                break;
-            }
+        const auto& sec = section(sec_fchk_natoms);
+        if (!sec.empty()) {
+            seek(sec.front());
+            std::string line;
+            std::getline(from, line);
+            std::istringstream iss(line.substr(line.find(pattern)));
+            char ignore;
+            iss.ignore(pattern.length(), '\n');
+            iss >> ignore >> natoms;
         }
     }
     if (natoms == 0) {
@@ -182,27 +206,27 @@ std::vector<double> Chem::Gauss_data::get_scf_zpe_energy() const
 {
     std::streampos orig_pos = from.tellg();
 
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-    from.clear();
-
     std::string buffer;
     double zpe_energy = 0.0;
     double tot_energy = 0.0;
     if (filetype == out) {
-        while (std::getline(from, buffer)) {
-            if (buffer.find("Zero-point correction=") != std::string::npos) {
-                std::istringstream iss(buffer);
-                iss >> buffer >> buffer >> zpe_energy;
-            }
-            if (buffer.find("Sum of electronic and zero-point Energies=") !=
-                std::string::npos) {
-                std::istringstream iss(buffer);
-                for (int i = 0; i < 6; ++i) {
-                    iss >> buffer; // ignore
-                }
-                iss >> tot_energy;
+        // The last entries are used:
+        const auto& zpe = section(sec_zpe);
+        if (!zpe.empty()) {
+            seek(zpe.back());
+            std::getline(from, buffer);
+            std::istringstream iss(buffer);
+            iss >> buffer >> buffer >> zpe_energy;
+        }
+        const auto& sum = section(sec_sum_zpe);
+        if (!sum.empty()) {
+            seek(sum.back());
+            std::getline(from, buffer);
+            std::istringstream iss(buffer);
+            for (int i = 0; i < 6; ++i) {
+                iss >> buffer; // ignore
             }
+            iss >> tot_energy;
         }
     }
     else { // fchk file
@@ -219,10 +243,6 @@ void Chem::Gauss_data::get_opt_cart_coord(struct Chem::Gauss_coord& coord) const
 {
     std::streampos orig_pos = from.tellg();
 
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-    from.clear();
-
     // Get number of atoms:
     coord.natoms = get_natoms();
 
@@ -232,59 +252,51 @@ void Chem::Gauss_data::get_opt_cart_coord(struct Chem::Gauss_coord& coord) const
     std::string line;
 
     if (filetype == out) {
-        bool conv = false;
-        while (std::getline(from, line)) {
-            if (line.find("Stationary point found.") != std::string::npos) {
-                conv = true;
-                while (std::getline(from, line)) {
-                    if (line.find("Standard orientation:") !=
-                        std::string::npos) {
-                        for (int i = 0; i < 4; ++i) {
-                            std::getline(from, line); // ignore four lines
-                        }
-                        int center;
-                        int atnum;
-                        int attype;
-                        double x;
-                        double y;
-                        double z;
-                        for (int i = 0; i < coord.natoms; ++i) {
-                            from >> center >> atnum >> attype >> x >> y >> z;
-                            coord.atnum[i] = atnum;
-                            coord.xyz(i, 0) = x;
-                            coord.xyz(i, 1) = y;
-                            coord.xyz(i, 2) = z;
-                        }
-                    }
-                }
-            }
-        }
-        if (!conv) {
+        const auto& stat = section(sec_stationary);
+        if (stat.empty()) {
             throw std::runtime_error("stationary point not found");
         }
+        // Use last standard orientation after the first stationary point:
+        const auto& orient = section(sec_std_orient);
+        if (!orient.empty() && orient.back() > stat.front()) {
+            seek(orient.back());
+            for (int i = 0; i < 5; ++i) {
+                std::getline(from, line); // ignore pattern and four lines
+            }
+            int center;
+            int atnum;
+            int attype;
+            double x;
+            double y;
+            double z;
+            for (int i = 0; i < coord.natoms; ++i) {
+                from >> center >> atnum >> attype >> x >> y >> z;
+                coord.atnum[i] = atnum;
+                coord.xyz(i, 0) = x;
+                coord.xyz(i, 1) = y;
+                coord.xyz(i, 2) = z;
+            }
+        }
     }
     else { // filetype == fchk
-        while (std::getline(from, line)) {
-            // Get atomic numbers:
-            std::string::size_type pos = line.find("Atomic numbers");
-            if (pos != std::string::npos) {
-                for (int i = 0; i < coord.natoms; ++i) {
-                    int atomic_number;
-                    from >> atomic_number;
-                    coord.atnum[i] = atomic_number;
-                }
+        // Get atomic numbers:
+        const auto& atnum = section(sec_fchk_atnum);
+        if (!atnum.empty()) {
+            seek(atnum.front());
+            std::getline(from, line);
+            if (!read_fchk_array(from, coord.atnum.data(), coord.natoms)) {
+                throw std::runtime_error(
+                    "could not read atomic numbers from fchk file");
             }
-            // Get current Cartesian coordinates:
-            pos = line.find("Current cartesian coordinates");
-            if (pos != std::string::npos) {
-                for (int i = 0; i < coord.natoms; ++i) {
-                    for (int j = 0; j < 3; ++j) {
-                        double x;
-                        from >> x;
-                        coord.xyz(i, j) = x;
-                    }
-                }
-                break;
+        }
+        // Get current Cartesian coordinates (stored row by row):
+        const auto& xyz = section(sec_fchk_xyz);
+        if (!xyz.empty()) {
+            seek(xyz.front());
+            std::getline(from, line);
+            if (!read_fchk_array(from, coord.xyz.data(), 3 * coord.natoms)) {
+                throw std::runtime_error(
+                    "could not read Cartesian coordinates from fchk file");
             }
         }
     }
@@ -298,21 +310,18 @@ void Chem::Gauss_data::get_freqs(std::vector<double>& freqs) const
     if (filetype == fchk) {
         throw std::runtime_error("not implemented for Gaussian fchk files");
     }
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-
     const std::string pattern = " Frequencies --";
 
     std::string line;
     double v;
 
-    while (std::getline(from, line)) {
-        if (line.find(pattern, 0) != std::string::npos) {
-            std::istringstream iss(line);
-            iss.ignore(pattern.size(), '\n');
-            while (iss >> v) {
-                freqs.push_back(v);
-            }
+    for (auto pos : section(sec_freqs)) {
+        seek(pos);
+        std::getline(from, line);
+        std::istringstream iss(line.substr(line.find(pattern)));
+        iss.ignore(pattern.size(), '\n');
+        while (iss >> v) {
+            freqs.push_back(v);
         }
     }
 }
@@ -323,28 +332,17 @@ void Chem::Gauss_data::get_hessians(
     if (filetype == out) {
         throw std::runtime_error("not implemented for Gaussian output files");
     }
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-
-    const std::string pattern = "Cartesian Force Constants";
-
     std::string line;
-    std::string buffer;
-    int n;
 
     Numlib::Vec<double> tmp;
-    while (std::getline(from, line)) {
-        if (line.find(pattern, 0) != std::string::npos) {
-            std::istringstream iss(line);
-            iss >> buffer >> buffer >> buffer >> buffer >> buffer >> n;
-            tmp.resize(n);
-            for (int i = 0; i < n; ++i) {
-                from >> tmp(i);
-                if (!from) {
-                    throw std::runtime_error(
-                        "could not read Hessians from fchk file");
-                }
-            }
+    const auto& sec = section(sec_fchk_force_const);
+    if (!sec.empty()) { // the last entry is used
+        seek(sec.back());
+        std::getline(from, line);
+        const int n = fchk_array_size(line);
+        tmp.resize(n);
+        if (!read_fchk_array(from, tmp.data(), n)) {
+            throw std::runtime_error("could not read Hessians from fchk file");
         }
     }
     hess = Numlib::Symm_mat<double, Numlib::lo>(tmp);
@@ -357,44 +355,35 @@ void Chem::Gauss_data::get_pes_scan_data(std::string& scan_coord,
     if (filetype == fchk) {
         throw std::runtime_error("not implemented for Gaussian fchk files");
     }
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-
-    const std::string summary_start =
-        "Summary of Optimized Potential Surface Scan";
-
     scan_coord = get_modredundant_coord();
 
+    const auto& sec = section(sec_scan_summary);
+    if (sec.empty()) {
+        throw std::runtime_error(
+            "Summary of Optimized Potential Surface Scan not found");
+    }
+    seek(sec.front());
+
     std::string line;
     std::string token;
     std::string ignore;
     double value;
 
-    bool summary_found = false;
-
+    std::getline(from, line); // summary_start
     while (std::getline(from, line)) {
-        if (line.find(summary_start, 0) != std::string::npos) {
-            summary_found = true;
-            while (std::getline(from, line)) {
-                std::istringstream iss(line);
-                iss >> token;
-                if (token == "Eigenvalues") {
-                    iss >> ignore;
-                    while (iss >> value) {
-                        energy.push_back(value);
-                    }
-                }
-                else if (token == scan_coord) {
-                    while (iss >> value) {
-                        coord.push_back(value);
-                    }
-                }
+        std::istringstream iss(line);
+        iss >> token;
+        if (token == "Eigenvalues") {
+            iss >> ignore;
+            while (iss >> value) {
+                energy.push_back(value);
+            }
+        }
+        else if (token == scan_coord) {
+            while (iss >> value) {
+                coord.push_back(value);
             }
         }
-    }
-    if (!summary_found) {
-        throw std::runtime_error(
-            "Summary of Optimized Potential Surface Scan not found");
     }
     if (energy.size() != coord.size()) {
         throw std::runtime_error("bad number of data read");
@@ -408,8 +397,8 @@ void Chem::Gauss_data::get_nmr_data(std::vector<Gauss_NMR>& nmr,
     if (filetype == fchk) {
         throw std::runtime_error("not implemented for Gaussian fchk files");
     }
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
+    // The pattern is given at runtime, hence the file is scanned:
+    seek(0);
 
     // Get NMR data:
 
@@ -461,35 +450,27 @@ int Chem::Gauss_data::get_no_irc_points() const
 {
     std::streampos orig_pos = from.tellg();
 
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-    from.clear();
-
     int npoints = 0;
 
     std::string line;
     if (filetype == out) {
         const std::string pattern = "-- Optimized point #";
-        while (std::getline(from, line)) {
-            if (line.find(pattern, 0) != std::string::npos) {
-                std::istringstream iss(Stdutils::trim(line, " "));
-                iss.ignore(pattern.length(), '\n');
-                iss >> npoints;
-            }
+        const auto& sec = section(sec_opt_point);
+        if (!sec.empty()) { // the last entry is used
+            seek(sec.back());
+            std::getline(from, line);
+            std::istringstream iss(Stdutils::trim(line, " "));
+            iss.ignore(pattern.length(), '\n');
+            iss >> npoints;
         }
         npoints += 1; // include starting point
     }
     else { // filetype == fchk
-        const std::string pattern =
-            "IRC point       1 Results for each geome   R   N=";
-
-        while (std::getline(from, line)) {
-            if (line.find(pattern, 0) != std::string::npos) {
-                std::istringstream iss(line);
-                iss.ignore(pattern.length(), '\n');
-                iss >> npoints;
-                break;
-            }
+        const auto& sec = section(sec_fchk_irc_results);
+        if (!sec.empty()) {
+            seek(sec.front());
+            std::getline(from, line);
+            npoints = fchk_array_size(line);
         }
         npoints /= 2;
     }
@@ -502,39 +483,29 @@ int Chem::Gauss_data::get_no_irc_points() const
 
 void Chem::Gauss_data::get_irc_data(std::vector<double>& mep) const
 {
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-
     std::string line;
     if (filetype == out) {
-        std::string pattern;
-        if (get_version() == g03) {
-            pattern = "Summary of reaction path following:";
-        }
-        else {
-            pattern = "SUMMARY OF REACTION PATH FOLLOWING:";
-        }
+        const auto& sec = section(get_version() == g03 ? sec_irc_summary_g03
+                                                       : sec_irc_summary);
         int count = 0;
-        while (std::getline(from, line)) {
-            if (line.find(pattern, 0) != std::string::npos) {
-                for (int i = 0; i < 3; ++i) { // ignore three lines
-                    from.ignore(256, '\n');
-                }
-                const int npoints = get_no_irc_points();
-                double vmep;
-                double smep;
-                int dummy;
-                while (count < npoints) {
-                    std::getline(from, line);
-                    std::istringstream iss(line);
-                    iss >> dummy >> vmep >> smep;
-                    if (iss) {
-                        if (smep != 0.0) { // do not include starting point
-                            mep.push_back(vmep);
-                            mep.push_back(smep);
-                        }
-                        count++;
+        if (!sec.empty()) {
+            const int npoints = get_no_irc_points();
+            seek(sec.front());
+            for (int i = 0; i < 4; ++i) { // ignore pattern and three lines
+                from.ignore(256, '\n');
+            }
+            double vmep;
+            double smep;
+            int dummy;
+            while (count < npoints && std::getline(from, line)) {
+                std::istringstream iss(line);
+                iss >> dummy >> vmep >> smep;
+                if (iss) {
+                    if (smep != 0.0) { // do not include starting point
+                        mep.push_back(vmep);
+                        mep.push_back(smep);
                     }
+                    count++;
                 }
             }
         }
@@ -544,86 +515,44 @@ void Chem::Gauss_data::get_irc_data(std::vector<double>& mep) const
         }
     }
     else { // filetype == fchk
-        const std::string pattern =
-            "IRC point       1 Results for each geome   R   N=";
-
         int n = 0;
-        while (std::getline(from, line)) {
-            if (line.find(pattern, 0) != std::string::npos) {
-                std::istringstream iss(line);
-                iss.ignore(pattern.length(), '\n');
-                iss >> n;
-                break;
-            }
-        }
-        if (n > 0) {
-            double val;
-            for (int i = 0; i < n; ++i) {
-                from >> val;
-                mep.push_back(val);
-            }
+        const auto& sec = section(sec_fchk_irc_results);
+        if (!sec.empty()) {
+            seek(sec.front());
+            std::getline(from, line);
+            n = fchk_array_size(line);
         }
-        else {
+        if (n <= 0) {
             throw std::runtime_error(
                 "could not find IRC data in Gaussian file");
         }
+        const std::size_t first = mep.size();
+        mep.resize(first + n);
+        if (!read_fchk_array(from, mep.data() + first, n)) {
+            throw std::runtime_error(
+                "could not read IRC data from fchk file");
+        }
     }
 }
 
 void Chem::Gauss_data::get_irc_geom(std::vector<double>& geom) const
 {
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-
     std::string line;
     if (filetype == out) {
-        const std::string pattern_geom = "Z-Matrix orientation:";
-        const std::string pattern_opt = "-- Optimized point #";
-
         const int natoms = get_natoms();
         const int natoms3 = 3 * natoms;
         const int npoints = get_no_irc_points();
 
         Gauss_version version = get_version();
 
-        // Temporary store all geometries; save last geometry if an
-        // optimized point was found.
+        const auto& opt = section(sec_opt_point);
 
         int count = 1;
-        std::vector<double> geom_tmp(natoms3);
-        while (count < npoints) {
-            std::getline(from, line);
-            if (line.find(pattern_geom, 0) != std::string::npos) {
-                geom_tmp.clear();
-                for (int i = 0; i < 4; ++i) { // ignore four lines
-                    from.ignore(256, '\n');
-                }
-                double dum1;
-                double dum2;
-                double dum3;
-                double x;
-                double y;
-                double z;
-                for (int i = 0; i < natoms; ++i) {
-                    std::getline(from, line);
-                    std::istringstream iss(line);
-                    if (version == g94) {
-                        iss >> dum1 >> dum2 >> x >> y >> z;
-                    }
-                    else {
-                        iss >> dum1 >> dum2 >> dum3 >> x >> y >> z;
-                    }
-                    geom_tmp.push_back(x);
-                    geom_tmp.push_back(y);
-                    geom_tmp.push_back(z);
-                }
-            }
-            if (line.find(pattern_opt, 0) != std::string::npos) {
-                for (int i = 0; i < natoms3; ++i) {
-                    geom.push_back(geom_tmp[i]);
-                }
-                count++;
-            }
+        for (std::size_t k = 0; k < opt.size() && count < npoints; ++k) {
+            const std::size_t first = geom.size();
+            geom.resize(first + natoms3);
+            read_irc_geom(k, natoms, version, geom.data() + first);
+            count++;
         }
         if (count == 0) {
             throw std::runtime_error(
@@ -631,79 +560,45 @@ void Chem::Gauss_data::get_irc_geom(std::vector<double>& geom) const
         }
     }
     else { // filetype == fchk
-        const std::string pattern =
-            "IRC point       1 Geometries               R   N=";
-
         int n = 0;
-        while (std::getline(from, line)) {
-            if (line.find(pattern, 0) != std::string::npos) {
-                std::istringstream iss(line);
-                iss.ignore(pattern.length(), '\n');
-                iss >> n;
-                break;
-            }
-        }
-        if (n > 0) {
-            double val;
-            for (int i = 0; i < n; ++i) {
-                from >> val;
-                geom.push_back(val);
-            }
+        const auto& sec = section(sec_fchk_irc_geom);
+        if (!sec.empty()) {
+            seek(sec.front());
+            std::getline(from, line);
+            n = fchk_array_size(line);
         }
-        else {
+        if (n <= 0) {
             throw std::runtime_error(
                 "could not find IRC geometries in Gaussian file");
         }
+        const std::size_t first = geom.size();
+        geom.resize(first + n);
+        if (!read_fchk_array(from, geom.data() + first, n)) {
+            throw std::runtime_error(
+                "could not read IRC geometries from fchk file");
+        }
     }
 }
 
 void Chem::Gauss_data::get_irc_grad(std::vector<double>& grad) const
 {
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-
     std::string line;
     if (filetype == out) {
-        const std::string pattern_grad =
-            "Center     Atomic                   Forces";
-        const std::string pattern_opt = "-- Optimized point #";
-
         const int natoms = get_natoms();
         const int natoms3 = 3 * natoms;
         const int npoints = get_no_irc_points();
 
-        // Temporary store all gradients; save last gradient if an
-        // optimized point was found.
+        const auto& opt = section(sec_opt_point);
 
         int count = 1;
-        std::vector<double> grad_tmp(natoms3);
-        while (count < npoints) {
-            std::getline(from, line);
-            if (line.find(pattern_grad, 0) != std::string::npos) {
-                grad_tmp.clear();
-                for (int i = 0; i < 2; ++i) { // ignore two lines
-                    from.ignore(256, '\n');
-                }
-                double dum1;
-                double dum2;
-                double dx;
-                double dy;
-                double dz;
-                for (int i = 0; i < natoms; ++i) {
-                    std::getline(from, line);
-                    std::istringstream iss(line);
-                    iss >> dum1 >> dum2 >> dx >> dy >> dz;
-                    grad_tmp.push_back(dx);
-                    grad_tmp.push_back(dy);
-                    grad_tmp.push_back(dz);
-                }
-            }
-            if (line.find(pattern_opt, 0) != std::string::npos) {
-                for (int i = 0; i < natoms3; ++i) {
-                    grad.push_back(-1.0 * grad_tmp[i]); // forces to gradients
-                }
-                count++;
+        for (std::size_t k = 0; k < opt.size() && count < npoints; ++k) {
+            const std::size_t first = grad.size();
+            grad.resize(first + natoms3);
+            read_irc_forces(k, natoms, grad.data() + first);
+            for (int i = 0; i < natoms3; ++i) {
+                grad[first + i] *= -1.0; // forces to gradients
             }
+            count++;
         }
         if (count == 0) {
             throw std::runtime_error(
@@ -711,76 +606,42 @@ void Chem::Gauss_data::get_irc_grad(std::vector<double>& grad) const
         }
     }
     else { // filetype == fchk
-        const std::string pattern =
-            "IRC point       1 Gradient at each geome   R   N=";
-
         int n = 0;
-        while (std::getline(from, line)) {
-            if (line.find(pattern, 0) != std::string::npos) {
-                std::istringstream iss(line);
-                iss.ignore(pattern.length(), '\n');
-                iss >> n;
-                break;
-            }
-        }
-        if (n > 0) {
-            double val;
-            for (int i = 0; i < n; ++i) {
-                from >> val;
-                grad.push_back(val);
-            }
+        const auto& sec = section(sec_fchk_irc_grad);
+        if (!sec.empty()) {
+            seek(sec.front());
+            std::getline(from, line);
+            n = fchk_array_size(line);
         }
-        else {
+        if (n <= 0) {
             throw std::runtime_error(
                 "could not find IRC gradients in Gaussian file");
         }
+        const std::size_t first = grad.size();
+        grad.resize(first + n);
+        if (!read_fchk_array(from, grad.data() + first, n)) {
+            throw std::runtime_error(
+                "could not read IRC gradients from fchk file");
+        }
     }
 }
 
 void Chem::Gauss_data::get_irc_hess(std::vector<double>& hess) const
 {
-    from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
-
     if (filetype == out) {
-        const std::string pattern_hess = " The second derivative matrix:";
-        const std::string pattern_opt = "-- Optimized point #";
-
         const int npoints = get_no_irc_points();
         const int natoms = get_natoms();
         const int natoms3 = 3 * natoms;
         const int nhess = natoms3 * (natoms3 + 1) / 2;
 
-        // Temporary store all Hessians; save last Hessians if an
-        // optimized point was found.
+        const auto& opt = section(sec_opt_point);
 
         int count = 1;
-        double fc;
-        std::string line;
-        std::string token;
-        std::string data;
-        std::vector<double> hess_tmp(nhess);
-        while (count < npoints) {
-            std::getline(from, line);
-            if (line.find(pattern_hess, 0) != std::string::npos) {
-                hess_tmp.clear();
-                while (from >> token) {
-                    std::getline(from, data);
-                    std::istringstream iss(data);
-                    while (iss >> fc) {
-                        hess_tmp.push_back(fc);
-                    }
-                    if (hess_tmp.size() >= narrow_cast<std::size_t>(nhess)) {
-                        break;
-                    }
-                }
-            }
-            if (line.find(pattern_opt, 0) != std::string::npos) {
-                for (int i = 0; i < nhess; ++i) {
-                    hess.push_back(hess_tmp[i]);
-                }
-                count++;
-            }
+        for (std::size_t k = 0; k < opt.size() && count < npoints; ++k) {
+            const std::size_t first = hess.size();
+            hess.resize(first + nhess);
+            read_irc_hess(k, nhess, hess.data() + first);
+            count++;
         }
         if (count == 0) {
             throw std::runtime_error(
@@ -794,16 +655,164 @@ void Chem::Gauss_data::get_irc_hess(std::vector<double>& hess) const
     }
 }
 
-std::string Chem::Gauss_data::get_modredundant_coord() const
+void Chem::Gauss_data::get_irc_data(int k, double& vmep, double& smep) const
+{
+    std::streampos orig_pos = from.tellg();
+
+    bool found = false;
+    if (filetype == out) {
+        const auto& sec = section(get_version() == g03 ? sec_irc_summary_g03
+                                                       : sec_irc_summary);
+        if (k >= 0 && k < get_no_irc_points() - 1 && !sec.empty()) {
+            seek(sec.front());
+            for (int i = 0; i < 4; ++i) { // ignore pattern and three lines
+                from.ignore(256, '\n');
+            }
+            // Rows are counted as by get_irc_data(), which skips the
+            // starting point:
+            std::string line;
+            int dummy;
+            int count = -1;
+            while (count < k && std::getline(from, line)) {
+                std::istringstream iss(line);
+                iss >> dummy >> vmep >> smep;
+                if (iss && smep != 0.0) {
+                    count++;
+                }
+            }
+            found = (count == k);
+        }
+    }
+    else { // filetype == fchk
+        double x[2];
+        found = read_fchk_block(sec_fchk_irc_results, 2 * k, 2, x);
+        if (found) {
+            vmep = x[0];
+            smep = x[1];
+        }
+    }
+    if (!found) {
+        throw std::runtime_error("could not read IRC point from Gaussian file");
+    }
+    from.clear();
+    from.seekg(orig_pos, std::ios_base::beg); // move to original position
+    from.clear();
+}
+
+void Chem::Gauss_data::get_irc_geom(int k, std::vector<double>& geom) const
+{
+    std::streampos orig_pos = from.tellg();
+
+    const int natoms3 = get_irc_natoms3();
+    geom.assign(natoms3, 0.0);
+
+    if (filetype == out) {
+        const auto& opt = section(sec_opt_point);
+        if (k < 0 || k >= get_no_irc_points() - 1 ||
+            narrow_cast<std::size_t>(k) >= opt.size()) {
+            throw std::runtime_error("IRC point out of range");
+        }
+        read_irc_geom(k, natoms3 / 3, get_version(), geom.data());
+    }
+    else { // filetype == fchk
+        if (!read_fchk_block(sec_fchk_irc_geom, k * natoms3, natoms3,
+                             geom.data())) {
+            throw std::runtime_error(
+                "could not read IRC geometry from fchk file");
+        }
+    }
+    from.clear();
+    from.seekg(orig_pos, std::ios_base::beg); // move to original position
+    from.clear();
+}
+
+void Chem::Gauss_data::get_irc_grad(int k, std::vector<double>& grad) const
+{
+    std::streampos orig_pos = from.tellg();
+
+    const int natoms3 = get_irc_natoms3();
+    grad.assign(natoms3, 0.0);
+
+    if (filetype == out) {
+        const auto& opt = section(sec_opt_point);
+        if (k < 0 || k >= get_no_irc_points() - 1 ||
+            narrow_cast<std::size_t>(k) >= opt.size()) {
+            throw std::runtime_error("IRC point out of range");
+        }
+        read_irc_forces(k, natoms3 / 3, grad.data());
+        for (auto& gi : grad) {
+            gi *= -1.0; // forces to gradients
+        }
+    }
+    else { // filetype == fchk
+        if (!read_fchk_block(sec_fchk_irc_grad, k * natoms3, natoms3,
+                             grad.data())) {
+            throw std::runtime_error(
+                "could not read IRC gradient from fchk file");
+        }
+    }
+    from.clear();
+    from.seekg(orig_pos, std::ios_base::beg); // move to original position
+    from.clear();
+}
+
+void Chem::Gauss_data::get_irc_hess(int k, std::vector<double>& hess) const
 {
     if (filetype == fchk) {
-        throw std::runtime_error("not implemented for Gaussian fchk files");
+        throw std::runtime_error(
+            "IRC Hessians can only be extracted from Gaussian output "
+            "files");
     }
+    std::streampos orig_pos = from.tellg();
+
+    const int natoms3 = 3 * get_natoms();
+    const int nhess = natoms3 * (natoms3 + 1) / 2;
+    hess.assign(nhess, 0.0);
+
+    const auto& opt = section(sec_opt_point);
+    if (k < 0 || k >= get_no_irc_points() - 1 ||
+        narrow_cast<std::size_t>(k) >= opt.size()) {
+        throw std::runtime_error("IRC point out of range");
+    }
+    read_irc_hess(k, nhess, hess.data());
+
     from.clear();
-    from.seekg(0, std::ios_base::beg); // move to beginning of file
+    from.seekg(orig_pos, std::ios_base::beg); // move to original position
+    from.clear();
+}
 
-    const std::string pattern = "!    Initial Parameters    !";
+int Chem::Gauss_data::get_irc_natoms3() const
+{
+    if (filetype == out) {
+        return 3 * get_natoms();
+    }
+    std::streampos orig_pos = from.tellg();
+
+    int n = 0;
+    const auto& sec = section(sec_fchk_irc_geom);
+    if (!sec.empty()) {
+        seek(sec.front());
+        std::string line;
+        std::getline(from, line);
+        n = fchk_array_size(line);
+    }
+    const int npoints = get_no_irc_points();
+    if (n <= 0 || npoints <= 0 || n % npoints != 0) {
+        throw std::runtime_error(
+            "could not find IRC geometries in Gaussian file");
+    }
+    from.clear();
+    from.seekg(orig_pos, std::ios_base::beg); // move to original position
+    from.clear();
 
+    return n / npoints;
+}
+
+std::string Chem::Gauss_data::get_modredundant_coord() const
+{
+    if (filetype == fchk) {
+        throw std::runtime_error("not implemented for Gaussian fchk files");
+    }
     std::string line;
     std::string name;
     std::string def;
@@ -811,17 +820,17 @@ std::string Chem::Gauss_data::get_modredundant_coord() const
     double val;
     char ch;
 
-    while (std::getline(from, line)) {
-        if (line.find(pattern, 0) != std::string::npos) {
-            for (int i = 0; i < 4; ++i) {
-                std::getline(from, line); // ignore
-            }
-            while (std::getline(from, line)) {
-                std::istringstream iss(line);
-                iss >> ch >> name >> def >> val >> deriv;
-                if (deriv == "Scan") {
-                    return name;
-                }
+    const auto& sec = section(sec_init_params);
+    if (!sec.empty()) {
+        seek(sec.front());
+        for (int i = 0; i < 5; ++i) {
+            std::getline(from, line); // ignore pattern and four lines
+        }
+        while (std::getline(from, line)) {
+            std::istringstream iss(line);
+            iss >> ch >> name >> def >> val >> deriv;
+            if (deriv == "Scan") {
+                return name;
             }
         }
     }
@@ -843,3 +852,259 @@ void Chem::Gauss_data::print_opt_geom(std::ostream& to) const
     to << '\n';
 }
 
+//------------------------------------------------------------------------------
+
+const std::vector<std::streamoff>& Chem::Gauss_data::section(
+    Chem::Gauss_data::Section sec) const
+{
+    if (index.empty()) {
+        build_index();
+    }
+    return index[sec];
+}
+
+void Chem::Gauss_data::build_index() const
+{
+    struct Pattern {
+        Section sec;
+        const char* str;
+    };
+
+    // Patterns for output files:
+    const Pattern pattern_out[] = {
+        {sec_cite, "Cite this work as:"},
+        {sec_error, "Error termination"},
+        {sec_stationary, "Stationary point found."},
+        {sec_std_orient, "Standard orientation:"},
+        {sec_zmat_orient, "Z-Matrix orientation:"},
+        {sec_zpe, "Zero-point correction="},
+        {sec_sum_zpe, "Sum of electronic and zero-point Energies="},
+        {sec_freqs, " Frequencies --"},
+        {sec_scan_summary, "Summary of Optimized Potential Surface Scan"},
+        {sec_init_params, "!    Initial Parameters    !"},
+        {sec_opt_point, "-- Optimized point #"},
+        {sec_irc_summary_g03, "Summary of reaction path following:"},
+        {sec_irc_summary, "SUMMARY OF REACTION PATH FOLLOWING:"},
+        {sec_forces, "Center     Atomic                   Forces"},
+        {sec_second_deriv, " The second derivative matrix:"}};
+
+    // Patterns for formatted checkpoint files:
+    const Pattern pattern_fchk[] = {
+        {sec_fchk_natoms, "Number of atoms"},
+        {sec_fchk_atnum, "Atomic numbers"},
+        {sec_fchk_xyz, "Current cartesian coordinates"},
+        {sec_fchk_force_const, "Cartesian Force Constants"},
+        {sec_fchk_irc_results,
+         "IRC point       1 Results for each geome   R   N="},
+        {sec_fchk_irc_geom, "IRC point       1 Geometries               R   N="},
+        {sec_fchk_irc_grad,
+         "IRC point       1 Gradient at each geome   R   N="}};
+
+    const Pattern* pbeg = std::begin(pattern_out);
+    const Pattern* pend = std::end(pattern_out);
+    if (filetype == fchk) {
+        pbeg = std::begin(pattern_fchk);
+        pend = std::end(pattern_fchk);
+    }
+
+    std::vector<std::vector<std::streamoff>> idx(num_sections);
+
+    from.clear();
+    from.seekg(0, std::ios_base::beg); // move to beginning of file
+    from.clear();
+
+    // Offsets are accumulated from line lengths rather than queried for
+    // each line:
+    std::streamoff pos = 0;
+    std::string line;
+    while (std::getline(from, line)) {
+        if (filetype == out) {
+            if (first_token_is(line, "Input")) {
+                idx[sec_input].push_back(pos);
+            }
+            else if (first_token_is(line, "Distance")) {
+                idx[sec_distance].push_back(pos);
+            }
+        }
+        for (const Pattern* p = pbeg; p != pend; ++p) {
+            if (line.find(p->str) != std::string::npos) {
+                idx[p->sec].push_back(pos);
+            }
+        }
+        pos += narrow_cast<std::streamoff>(line.size()) + 1;
+    }
+    index = std::move(idx);
+}
+
+void Chem::Gauss_data::seek(std::streamoff pos) const
+{
+    from.clear();
+    from.seekg(pos, std::ios_base::beg);
+    from.clear();
+}
+
+void Chem::Gauss_data::read_irc_geom(std::size_t k,
+                                     int natoms,
+                                     Chem::Gauss_version version,
+                                     double* x) const
+{
+    // The last geometry preceding the optimized point is used:
+    std::fill(x, x + 3 * natoms, 0.0);
+    std::streamoff pos;
+    if (!last_before(section(sec_zmat_orient), section(sec_opt_point)[k],
+                     pos)) {
+        return;
+    }
+    seek(pos);
+    for (int i = 0; i < 5; ++i) { // ignore pattern and four lines
+        from.ignore(256, '\n');
+    }
+    std::string line;
+    double dum1;
+    double dum2;
+    double dum3;
+    for (int i = 0; i < natoms; ++i) {
+        std::getline(from, line);
+        std::istringstream iss(line);
+        if (version == g94) {
+            iss >> dum1 >> dum2;
+        }
+        else {
+            iss >> dum1 >> dum2 >> dum3;
+        }
+        iss >> x[3 * i] >> x[3 * i + 1] >> x[3 * i + 2];
+    }
+}
+
+void Chem::Gauss_data::read_irc_forces(std::size_t k,
+                                       int natoms,
+                                       double* x) const
+{
+    // The last forces preceding the optimized point are used:
+    std::fill(x, x + 3 * natoms, 0.0);
+    std::streamoff pos;
+    if (!last_before(section(sec_forces), section(sec_opt_point)[k], pos)) {
+        return;
+    }
+    seek(pos);
+    for (int i = 0; i < 3; ++i) { // ignore pattern and two lines
+        from.ignore(256, '\n');
+    }
+    std::string line;
+    double dum1;
+    double dum2;
+    for (int i = 0; i < natoms; ++i) {
+        std::getline(from, line);
+        std::istringstream iss(line);
+        iss >> dum1 >> dum2 >> x[3 * i] >> x[3 * i + 1] >> x[3 * i + 2];
+    }
+}
+
+void Chem::Gauss_data::read_irc_hess(std::size_t k, int nhess, double* x) const
+{
+    // The last Hessian preceding the optimized point is used:
+    std::fill(x, x + nhess, 0.0);
+    std::streamoff pos;
+    if (!last_before(section(sec_second_deriv), section(sec_opt_point)[k],
+                     pos)) {
+        return;
+    }
+    seek(pos);
+    from.ignore(256, '\n'); // ignore pattern
+
+    int count = 0;
+    double fc;
+    std::string token;
+    std::string data;
+    while (count < nhess && from >> token) {
+        std::getline(from, data);
+        std::istringstream iss(data);
+        while (count < nhess && iss >> fc) {
+            x[count++] = fc;
+        }
+    }
+}
+
+bool Chem::Gauss_data::read_fchk_block(Chem::Gauss_data::Section sec,
+                                       int first,
+                                       int n,
+                                       double* x) const
+{
+    const auto& offsets = section(sec);
+    if (offsets.empty()) {
+        return false;
+    }
+    std::string line;
+    seek(offsets.front());
+    std::getline(from, line);
+    const int size = fchk_array_size(line);
+    if (first < 0 || n < 0 || first + n > size) {
+        return false;
+    }
+    const std::streamoff data =
+        offsets.front() + narrow_cast<std::streamoff>(line.size()) + 1;
+
+    // Arrays are written with five 16-character fields per line, so the
+    // line holding the first element is sought directly. If it does not
+    // start a line of the expected length, the lines are skipped one by
+    // one instead:
+    const int row = first / 5;
+    const std::streamoff row_pos =
+        data + narrow_cast<std::streamoff>(row) * 81;
+    const auto row_len =
+        narrow_cast<std::size_t>(16 * std::min(5, size - 5 * row));
+    char prev = '\n';
+    if (row > 0) {
+        seek(row_pos - 1);
+        from.get(prev);
+    }
+    if (prev == '\n' && std::getline(from, line) && line.size() == row_len) {
+        seek(row_pos);
+    }
+    else {
+        seek(data);
+        for (int i = 0; i < row; ++i) {
+            from.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+    }
+    std::vector<double> tmp(first % 5 + n);
+    if (!read_fchk_array(from, tmp.data(), narrow_cast<int>(tmp.size()))) {
+        return false;
+    }
+    std::copy(tmp.begin() + first % 5, tmp.end(), x);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+Chem::Fchk_writer::Fchk_writer(std::ostream& to_)
+    : to(to_), count(0), wrote_endl(false)
+{
+    sci.scientific_E().width(16).precision(8);
+}
+
+void Chem::Fchk_writer::put(double value)
+{
+    to << sci(value);
+    count++;
+    wrote_endl = false;
+    if (count == 5) {
+        to << '\n';
+        count = 0;
+        wrote_endl = true;
+    }
+}
+
+void Chem::Fchk_writer::put(const std::vector<double>& values)
+{
+    for (auto v : values) {
+        put(v);
+    }
+}
+
+void Chem::Fchk_writer::finish()
+{
+    if (!wrote_endl) {
+        to << '\n';
+    }
+}
@@ -7,8 +7,116 @@
 #include <chem/gauss_data.h>
 #include <chem/gaussian.h>
 #include <stdutils/stdutils.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
 #include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Class for reading lines appended to a file that is still being written.
+class Log_tail {
+public:
+    explicit Log_tail(const std::string& fname) : filename(fname) {}
+
+    // Get next complete line; returns false if none is available yet.
+    bool next_line(std::string& line)
+    {
+        if (!from.is_open()) {
+            from.open(filename);
+            if (!from.is_open()) { // file not created yet
+                return false;
+            }
+        }
+        char c;
+        while (from.get(c)) {
+            if (c == '\n') {
+                line.swap(partial);
+                partial.clear();
+                return true;
+            }
+            partial += c;
+        }
+        from.clear(); // clear EOF and wait for more output
+        return false;
+    }
+
+private:
+    std::string filename;
+    std::string partial;
+    std::ifstream from;
+};
+
+// Add read to the guess option of route, so that guess=mix becomes
+// guess=(read,mix); guess=read is appended if there is no guess option.
+// Returns false if the guess option selects another source of the initial
+// guess, which cannot be combined with read.
+bool merge_guess_read(std::string& route)
+{
+    std::string lower = route;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+    std::size_t first = 0;
+    while ((first = lower.find("guess", first)) != std::string::npos) {
+        if (first == 0 || std::isspace(static_cast<unsigned char>(
+                              lower[first - 1]))) {
+            break;
+        }
+        first += 5;
+    }
+    if (first == std::string::npos) {
+        route += " guess=read";
+        return true;
+    }
+
+    // Find options given as guess=opt, guess=(opt,...) or guess(opt,...):
+    std::size_t pos = first + 5;
+    if (pos < lower.size() && lower[pos] == '=') {
+        ++pos;
+    }
+    std::size_t last = pos;
+    if (pos < lower.size() && lower[pos] == '(') {
+        last = std::min(lower.find(')', pos), lower.size() - 1) + 1;
+    }
+    else {
+        while (last < lower.size() &&
+               !std::isspace(static_cast<unsigned char>(lower[last]))) {
+            ++last;
+        }
+    }
+    std::string opts = Stdutils::trim(route.substr(pos, last - pos), "() ");
+
+    // Sources of the initial guess other than read:
+    const std::vector<std::string> sources = {"huckel", "core",  "harris",
+                                              "indo",   "cndo",  "am1",
+                                              "cards",  "input", "fragment",
+                                              "generate"};
+    std::istringstream iss(lower.substr(pos, last - pos));
+    std::string opt;
+    while (std::getline(iss, opt, ',')) {
+        opt = Stdutils::trim(opt, " ()");
+        if (opt == "read") {
+            return true;
+        }
+        if (std::find(sources.begin(), sources.end(), opt) != sources.end()) {
+            return false;
+        }
+    }
+    route.replace(first, last - first,
+                  opts.empty() ? "guess=read" : "guess=(read," + opts + ")");
+    return true;
+}
+
+} // namespace
+
+constexpr double Chem::Gaussian::emax_default;
 
 void Chem::Gaussian::init(std::istream& from, const std::string& key)
 {
@@ -17,6 +125,15 @@ void Chem::Gaussian::init(std::istream& from, const std::string& key)
     // Read input data:
 
     int nosave_tmp = 1;
+    abort_energy = emax_default;
+    abort_min_steps = 3;
+    abort_steps = 0;
+    abort_stall = 0;
+    poll_ms = 200;
+    std::string cache_dir;
+    double cache_tol = 1.0e-4;
+    std::string guess_dir;
+    int guess_max = 50;
 
     auto pos = find_token(from, key);
     if (pos != -1) {
@@ -24,6 +141,16 @@ void Chem::Gaussian::init(std::istream& from, const std::string& key)
         get_token_value(from, pos, "jobname", jobname, std::string("gauss"));
         get_token_value(from, pos, "nprocshared", nprocshared, 1);
         get_token_value(from, pos, "nosave", nosave_tmp, nosave_tmp);
+        get_token_value(from, pos, "cache_dir", cache_dir, std::string(""));
+        get_token_value(from, pos, "cache_tol", cache_tol, 1.0e-4);
+        get_token_value(from, pos, "abort_energy", abort_energy, emax_default);
+        get_token_value(from, pos, "abort_min_steps", abort_min_steps, 3);
+        get_token_value(from, pos, "abort_steps", abort_steps, 0);
+        get_token_value(from, pos, "abort_stall", abort_stall, 0);
+        get_token_value(from, pos, "poll_ms", poll_ms, 200);
+        get_token_value(from, pos, "guess_dir", guess_dir, std::string(""));
+        get_token_value(from, pos, "guess_rmsd", guess_rmsd, 0.5);
+        get_token_value(from, pos, "guess_max", guess_max, 50);
         pos = find_token(from, "keywords", pos);
         if (pos != -1) {
             std::getline(from, keywords);
@@ -41,17 +168,65 @@ void Chem::Gaussian::init(std::istream& from, const std::string& key)
         nosave = true;
     }
     Assert::dynamic(nprocshared >= 1, "bad nprocshared value");
+    Assert::dynamic(abort_min_steps >= 0, "bad abort_min_steps value");
+    Assert::dynamic(abort_steps >= 0, "bad abort_steps value");
+    Assert::dynamic(abort_stall >= 0, "bad abort_stall value");
+    Assert::dynamic(poll_ms > 0, "bad poll_ms value");
+    Assert::dynamic(guess_rmsd > 0.0, "bad guess_rmsd value");
+    Assert::dynamic(guess_max > 0, "bad guess_max value");
+
+    cache.reset();
+    if (!cache_dir.empty()) {
+        cache = std::make_shared<Chem::Qm_cache>(cache_dir, cache_tol);
+    }
+    guess.reset();
+    std::string route = keywords;
+    if (!guess_dir.empty() && !merge_guess_read(route)) {
+        std::cerr << "warning: guess store is not used, since guess option in "
+                     "keywords cannot be combined with guess=read\n";
+    }
+    else if (!guess_dir.empty()) {
+        guess = std::make_shared<Chem::Guess_store>(guess_dir, ".chk",
+                                                    guess_max);
+    }
 }
 
 void Chem::Gaussian::run(Chem::Molecule& mol) const
 {
-    write_com(mol); // create Gaussian input file
+    std::string cache_key;
+    if (cache) {
+        cache_key = cache->key("Gaussian|" + keywords, mol);
+        if (cache->lookup(cache_key, mol)) {
+            return; // result is already computed
+        }
+    }
+
+    std::string oldchk;
+    if (guess) { // use checkpoint file of closest stored structure
+        oldchk = jobname + "_guess.chk";
+        if (!guess->fetch(mol, guess_rmsd, oldchk)) {
+            oldchk.clear();
+        }
+    }
+    write_com(mol, oldchk); // create Gaussian input file
 
     bool ok = true;
     std::string cmd = version + " " + jobname;
-    if (std::system(cmd.c_str()) != 0) {
+    std::remove((jobname + ".log").c_str()); // do not monitor old log file
+    Chem::Process proc(cmd);
+    if (abort_requested()) {
+        if (!monitor(proc)) {
+            ok = false; // job was aborted
+        }
+    }
+    if (proc.wait() != 0) {
         ok = false; // running Gaussian failed
     }
+    if (!ok) {
+        constexpr double emax = 0.0;
+        mol.elec().set_energy(emax);
+        return;
+    }
 
     std::ifstream logfile;
     Stdutils::fopen(logfile, jobname + ".log");
@@ -68,6 +243,12 @@ void Chem::Gaussian::run(Chem::Molecule& mol) const
         data.get_opt_cart_coord(coord);
         mol.set_xyz(coord.xyz); // update Cartesian coordinates
         mol.elec().set_energy(data.get_scf_zpe_energy()[0]); // update energy
+        if (cache) {
+            cache->store(cache_key, mol);
+        }
+        if (guess) {
+            guess->store(mol, jobname + ".chk");
+        }
     }
     else { // calculation failed to converge; set energy to zero:
         constexpr double emax = 0.0;
@@ -75,18 +256,88 @@ void Chem::Gaussian::run(Chem::Molecule& mol) const
     }
 }
 
+void Chem::Gaussian::run_batch(std::vector<Chem::Molecule>& mols) const
+{
+    for (auto& mol : mols) {
+        run(mol);
+    }
+}
+
 //------------------------------------------------------------------------------
 
-void Chem::Gaussian::write_com(const Chem::Molecule& mol) const
+bool Chem::Gaussian::monitor(Chem::Process& proc) const
+{
+    Log_tail tail(jobname + ".log");
+
+    int step = 0;         // current optimization step
+    int last_improve = 0; // step where lowest energy was last improved
+    double escf = 0.0;    // current SCF energy
+    double elow = emax_default;
+    const double stall_tol = 1.0e-6;
+
+    bool running = true;
+    while (running) {
+        running = proc.running();
+
+        std::string line;
+        while (tail.next_line(line)) {
+            if (line.find("SCF Done:") != std::string::npos) {
+                auto pos = line.find('=');
+                if (pos == std::string::npos) {
+                    continue;
+                }
+                std::istringstream iss(line.substr(pos + 1));
+                if (!(iss >> escf)) {
+                    continue;
+                }
+                if (escf < elow - stall_tol) {
+                    elow = escf;
+                    last_improve = step;
+                }
+                if (step >= abort_min_steps && escf > abort_energy) {
+                    proc.kill();
+                    return false;
+                }
+            }
+            else if (line.find("Step number") != std::string::npos) {
+                std::istringstream iss(line);
+                std::string tmp;
+                iss >> tmp >> tmp >> step;
+                if (abort_steps > 0 && step > abort_steps) {
+                    proc.kill();
+                    return false;
+                }
+                if (abort_stall > 0 && step - last_improve > abort_stall) {
+                    proc.kill();
+                    return false;
+                }
+            }
+        }
+        if (running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(poll_ms));
+        }
+    }
+    return true;
+}
+
+void Chem::Gaussian::write_com(const Chem::Molecule& mol,
+                               const std::string& oldchk) const
 {
     std::ofstream to;
     Stdutils::fopen(to, jobname + ".com");
-    to << "%nprocshared=" << nprocshared << '\n'
-       << "%chk=" << jobname << ".chk" << '\n';
-    if (nosave) {
+    to << "%nprocshared=" << nprocshared << '\n';
+    if (!oldchk.empty()) {
+        to << "%oldchk=" << oldchk << '\n';
+    }
+    to << "%chk=" << jobname << ".chk" << '\n';
+    if (nosave && !guess) { // checkpoint file is needed by guess store
         to << "%nosave\n";
     }
-    to << "# " << keywords << "\n\n"
+    std::string route = keywords;
+    if (!oldchk.empty()) {
+        merge_guess_read(route); // checked by init()
+    }
+    to << "# " << route << "\n\n"
        << mol.title() << "\n\n"
        << mol.elec().charge() << " " << mol.elec().spin_mult() << '\n';
 
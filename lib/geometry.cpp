@@ -44,6 +44,7 @@ Chem::Geometry::Geometry(std::istream& from, const std::string& key)
 
 std::vector<Numlib::Vec<Index>> Chem::Geometry::get_connectivities() const
 {
+    update_zmat();
     std::vector<Numlib::Vec<Index>> connect(0);
     if (!atms.empty()) {
         Numlib::Vec<Index> ivec1 = {bond_connect(1)};
@@ -74,7 +75,7 @@ void Chem::Geometry::rotate_moiety(const std::vector<Index>& moiety,
     }
 }
 
-void Chem::Geometry::build_zmat()
+void Chem::Geometry::build_zmat() const
 {
     Numlib::Mat<double> dist_mat;
     Numlib::pdist_matrix(dist_mat, xyz);
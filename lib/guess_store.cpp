@@ -0,0 +1,102 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/guess_store.h>
+#include <chem/rmsd.h>
+#include <stdutils/stdutils.h>
+#include <fstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+Chem::Guess_store::Guess_store(const std::string& dir,
+                               const std::string& ext,
+                               std::size_t nmax)
+    : store_dir(dir), file_ext(ext), max_size(nmax), next(0)
+{
+    Assert::dynamic(!store_dir.empty(), "bad guess store directory");
+    Assert::dynamic(max_size > 0, "bad size of guess store");
+
+    // Create store directory if it does not exist:
+#ifdef _WIN32
+    _mkdir(store_dir.c_str());
+#else
+    mkdir(store_dir.c_str(), 0755);
+#endif
+}
+
+bool Chem::Guess_store::fetch(const Chem::Molecule& mol,
+                              double rmsd_max,
+                              const std::string& dest)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    const auto& xyz = mol.get_xyz();
+    const Index natoms = narrow_cast<Index>(mol.num_atoms());
+
+    std::size_t best = coords.size();
+    double rmsd_best = rmsd_max;
+    for (std::size_t i = 0; i < coords.size(); ++i) {
+        if (coords[i].size() != 3 * mol.num_atoms()) {
+            continue;
+        }
+        double rmsd =
+            Chem::qcp_rmsd(coords[i].data(), xyz.data(), natoms, rmsd_best);
+        if (rmsd < rmsd_best) {
+            rmsd_best = rmsd;
+            best = i;
+        }
+    }
+    if (best == coords.size()) {
+        return false;
+    }
+    return Chem::copy_file(files[best], dest);
+}
+
+void Chem::Guess_store::store(const Chem::Molecule& mol,
+                              const std::string& file)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    std::size_t slot = coords.size();
+    if (slot == max_size) { // replace oldest entry
+        slot = next;
+        next = (next + 1) % max_size;
+    }
+    std::string dest = store_dir + "/guess" + std::to_string(slot) + file_ext;
+    if (!Chem::copy_file(file, dest)) {
+        return; // keep store unchanged
+    }
+
+    const auto& xyz = mol.get_xyz();
+    std::vector<double> x(xyz.data(), xyz.data() + xyz.size());
+    if (slot == coords.size()) {
+        coords.push_back(std::move(x));
+        files.push_back(dest);
+    }
+    else {
+        coords[slot] = std::move(x);
+        files[slot] = dest;
+    }
+}
+
+bool Chem::copy_file(const std::string& src, const std::string& dest)
+{
+    std::ifstream from(src, std::ios_base::binary);
+    if (!from) {
+        return false;
+    }
+    std::ofstream to(dest, std::ios_base::binary | std::ios_base::trunc);
+    if (!to) {
+        return false;
+    }
+    to << from.rdbuf();
+    return static_cast<bool>(to);
+}
@@ -70,14 +70,15 @@ void Chem::read_zmat_format(std::istream& from,
     while (std::getline(from, line)) {
         std::istringstream iss(line);
         iss >> symbol;
+        auto elem = Periodic_table::find_element(symbol);
         if (symbol.find("#") != std::string::npos) {
             continue;
         }
         else if (symbol.find("zmatrix") != std::string::npos) {
             pos = from.tellg();
         }
-        else if (Periodic_table::atomic_symbol_is_valid(symbol)) {
-            atoms.push_back(Periodic_table::get_element(symbol));
+        else if (elem.valid()) {
+            atoms.push_back(elem.element());
             natoms += 1;
         }
         else if (symbol.empty()) {
@@ -0,0 +1,194 @@
+// Copyright (c) 2009-2018 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/irc_merge.h>
+#include <stdutils/stdutils.h>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Class providing a k-way merge of IRC points from sorted segments.
+class Irc_merge {
+public:
+    Irc_merge(const std::vector<const Chem::Gauss_data*>& segs_,
+              const std::vector<int>& npoints_,
+              bool ascending);
+
+    // Get next point; returns false when all segments are exhausted.
+    bool next(std::size_t& seg, int& point);
+
+private:
+    struct Head {
+        double smep;
+        std::size_t seg;
+        int point;
+    };
+
+    // Push next point of segment to heap.
+    void push(std::size_t seg, int point);
+
+    const std::vector<const Chem::Gauss_data*>& segs;
+    const std::vector<int>& npoints;
+    bool first;
+    double last_smep;
+    using Compare = std::function<bool(const Head&, const Head&)>;
+    std::priority_queue<Head, std::vector<Head>, Compare> heap;
+};
+
+const std::string pattern_irc_data =
+    "IRC point       1 Results for each geome   R   N=";
+
+const std::string pattern_irc_geom =
+    "IRC point       1 Geometries               R   N=";
+
+const std::string pattern_irc_grad =
+    "IRC point       1 Gradient at each geome   R   N=";
+
+// Tolerance for identical reaction coordinates.
+const double smep_tol = 1.0e-6;
+
+Irc_merge::Irc_merge(const std::vector<const Chem::Gauss_data*>& segs_,
+                     const std::vector<int>& npoints_,
+                     bool ascending)
+    : segs(segs_),
+      npoints(npoints_),
+      first(true),
+      last_smep(0.0),
+      heap([ascending](const Head& a, const Head& b) {
+          // The next point in the merge direction is on top; ties are
+          // taken from the earliest segment:
+          if (a.smep != b.smep) {
+              return ascending ? a.smep > b.smep : a.smep < b.smep;
+          }
+          return a.seg > b.seg;
+      })
+{
+    for (std::size_t i = 0; i < segs.size(); ++i) {
+        push(i, 0);
+    }
+}
+
+bool Irc_merge::next(std::size_t& seg, int& point)
+{
+    while (!heap.empty()) {
+        Head h = heap.top();
+        heap.pop();
+        push(h.seg, h.point + 1);
+
+        if (first || std::abs(h.smep - last_smep) > smep_tol) {
+            first = false;
+            last_smep = h.smep;
+            seg = h.seg;
+            point = h.point;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Irc_merge::push(std::size_t seg, int point)
+{
+    if (point < npoints[seg]) {
+        double vmep;
+        double smep;
+        segs[seg]->get_irc_data(point, vmep, smep);
+        heap.push({smep, seg, point});
+    }
+}
+
+} // namespace
+
+int Chem::merge_irc(const std::vector<const Gauss_data*>& segs,
+                    std::ostream& to)
+{
+    // The number of coordinates of each point is taken from the IRC
+    // geometries, since sorted files have no other records:
+
+    std::vector<int> npoints(segs.size());
+    int natoms3 = 0;
+    for (std::size_t i = 0; i < segs.size(); ++i) {
+        npoints[i] = segs[i]->get_no_irc_points();
+        if (npoints[i] == 0) {
+            continue;
+        }
+        const int n = segs[i]->get_irc_natoms3();
+        if (natoms3 == 0) {
+            natoms3 = n;
+        }
+        else if (n != natoms3) {
+            throw std::runtime_error("number of atoms differs in IRC files");
+        }
+    }
+
+    // Direction of reaction coordinate is taken from the first file:
+
+    bool ascending = true;
+    if (!segs.empty() && npoints[0] > 1) {
+        double vmep;
+        double s0;
+        double s1;
+        segs[0]->get_irc_data(0, vmep, s0);
+        segs[0]->get_irc_data(npoints[0] - 1, vmep, s1);
+        ascending = s0 <= s1;
+    }
+
+    Stdutils::Format<std::size_t> fmt;
+    fmt.width(12);
+
+    // Write MEP data; the array size is patched when the number of merged
+    // points is known:
+
+    to << pattern_irc_data;
+    const auto size_pos = to.tellp();
+    to << fmt(0) << '\n';
+
+    std::size_t seg;
+    int point;
+    int nmerged = 0;
+    std::vector<double> data(2);
+
+    Chem::Fchk_writer mep_writer(to);
+    Irc_merge merge_mep(segs, npoints, ascending);
+    while (merge_mep.next(seg, point)) {
+        segs[seg]->get_irc_data(point, data[0], data[1]);
+        mep_writer.put(data);
+        ++nmerged;
+    }
+    mep_writer.finish();
+
+    const auto end_pos = to.tellp();
+    to.seekp(size_pos);
+    to << fmt(2 * nmerged);
+    to.seekp(end_pos);
+
+    // Write geometries and gradients:
+
+    const std::size_t n = static_cast<std::size_t>(natoms3) * nmerged;
+
+    to << pattern_irc_geom << fmt(n) << '\n';
+    Chem::Fchk_writer geom_writer(to);
+    Irc_merge merge_geom(segs, npoints, ascending);
+    while (merge_geom.next(seg, point)) {
+        segs[seg]->get_irc_geom(point, data);
+        geom_writer.put(data);
+    }
+    geom_writer.finish();
+
+    to << pattern_irc_grad << fmt(n) << '\n';
+    Chem::Fchk_writer grad_writer(to);
+    Irc_merge merge_grad(segs, npoints, ascending);
+    while (merge_grad.next(seg, point)) {
+        segs[seg]->get_irc_grad(point, data);
+        grad_writer.put(data);
+    }
+    grad_writer.finish();
+
+    return nmerged;
+}
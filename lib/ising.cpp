@@ -5,16 +5,206 @@
 // and conditions.
 
 #include <chem/ising.h>
+#include <numlib/constants.h>
 #include <stdutils/stdutils.h>
 #include <stdexcept>
 #include <cmath>
-#include <fstream>
+#include <algorithm>
+#include <complex>
+#include <numeric>
+#include <vector>
 
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+namespace {
+
+// Find root of cluster with path halving.
+inline int find(std::vector<int>& parent, int i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// Join clusters of two sites; the lowest site becomes the root.
+inline void unite(std::vector<int>& parent, int i, int j)
+{
+    i = find(parent, i);
+    j = find(parent, j);
+    if (i < j) {
+        parent[j] = i;
+    }
+    else if (j < i) {
+        parent[i] = j;
+    }
+}
+
+// Largest prime size transformed directly by the fft.
+constexpr int max_direct_dft = 31;
+
+void fft(const std::complex<double>* in,
+         std::complex<double>* out,
+         int n,
+         int stride,
+         const std::vector<std::complex<double>>& w,
+         int wstride);
+
+// Compute out[k] = sum_j in[j * stride] exp(sign 2 pi i j k / n) by
+// Bluestein's algorithm, where jk = (j^2 + k^2 - (k - j)^2) / 2 turns the
+// transform into a cyclic convolution of power of two size.
+void bluestein(const std::complex<double>* in,
+               std::complex<double>* out,
+               int n,
+               int stride,
+               int sign)
+{
+    const double pi = Numlib::Constants::pi;
+    int m = 1;
+    while (m < 2 * n - 1) {
+        m *= 2;
+    }
+    std::vector<std::complex<double>> chirp(n);
+    for (int j = 0; j < n; ++j) {
+        const long long jj = static_cast<long long>(j) * j % (2 * n);
+        chirp[j] = std::polar(1.0, sign * pi * jj / n);
+    }
+    std::vector<std::complex<double>> w(m);
+    for (int j = 0; j < m; ++j) {
+        w[j] = std::polar(1.0, -2.0 * pi * j / m);
+    }
+    std::vector<std::complex<double>> a(m);
+    std::vector<std::complex<double>> b(m);
+    for (int j = 0; j < n; ++j) {
+        a[j] = in[j * stride] * chirp[j];
+    }
+    b[0] = std::conj(chirp[0]);
+    for (int j = 1; j < n; ++j) {
+        b[j] = std::conj(chirp[j]);
+        b[m - j] = b[j];
+    }
+    std::vector<std::complex<double>> fa(m);
+    std::vector<std::complex<double>> fb(m);
+    fft(a.data(), fa.data(), m, 1, w, 1);
+    fft(b.data(), fb.data(), m, 1, w, 1);
+
+    // Inverse transform as conj(fft(conj(x))) / m:
+    for (int j = 0; j < m; ++j) {
+        fa[j] = std::conj(fa[j] * fb[j]);
+    }
+    fft(fa.data(), a.data(), m, 1, w, 1);
+    for (int k = 0; k < n; ++k) {
+        out[k] = chirp[k] * std::conj(a[k]) / static_cast<double>(m);
+    }
+}
+
+// Compute out[k] = sum_j in[j * stride] exp(sign 2 pi i j k / n) by the
+// mixed-radix Cooley-Tukey algorithm, where w holds the roots of unity of
+// the full transform and w[wstride] is exp(sign 2 pi i / n). Small prime
+// sizes are transformed directly and larger ones by Bluestein's algorithm.
+// Since the smallest factor is split off first, the cost is O(n log n)
+// unless n has two or more large prime factors.
+void fft(const std::complex<double>* in,
+         std::complex<double>* out,
+         int n,
+         int stride,
+         const std::vector<std::complex<double>>& w,
+         int wstride)
+{
+    if (n == 1) {
+        out[0] = in[0];
+        return;
+    }
+    int p = 2;
+    while (p * p <= n && n % p != 0) {
+        ++p;
+    }
+    if (n % p != 0) {
+        if (n > max_direct_dft) {
+            const int sign = w[wstride].imag() > 0.0 ? 1 : -1;
+            bluestein(in, out, n, stride, sign);
+            return;
+        }
+        for (int k = 0; k < n; ++k) {
+            std::complex<double> sum = 0.0;
+            for (int j = 0; j < n; ++j) {
+                sum += in[j * stride] * w[(j * k % n) * wstride];
+            }
+            out[k] = sum;
+        }
+        return;
+    }
+    // Transform p interleaved subsequences and combine them:
+    const int m = n / p;
+    for (int q = 0; q < p; ++q) {
+        fft(in + q * stride, out + q * m, m, stride * p, w, wstride * p);
+    }
+    std::vector<std::complex<double>> tmp(p);
+    for (int k = 0; k < m; ++k) {
+        for (int r = 0; r < p; ++r) {
+            std::complex<double> sum = 0.0;
+            for (int q = 0; q < p; ++q) {
+                sum += out[q * m + k] * w[(q * (k + r * m) % n) * wstride];
+            }
+            tmp[r] = sum;
+        }
+        for (int r = 0; r < p; ++r) {
+            out[k + r * m] = tmp[r];
+        }
+    }
+}
+
+// Compute two-dimensional discrete Fourier transform of n x n array.
+void fft2(std::vector<std::complex<double>>& a, int n, int sign)
+{
+    const double pi = Numlib::Constants::pi;
+    std::vector<std::complex<double>> w(n);
+    for (int j = 0; j < n; ++j) {
+        w[j] = std::polar(1.0, sign * 2.0 * pi * j / n);
+    }
+#pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+        std::vector<std::complex<double>> row(a.begin() + i * n,
+                                              a.begin() + (i + 1) * n);
+        fft(row.data(), &a[i * n], n, 1, w, 1);
+    }
+#pragma omp parallel for
+    for (int j = 0; j < n; ++j) {
+        std::vector<std::complex<double>> col(n);
+        fft(&a[j], col.data(), n, n, w, 1);
+        for (int i = 0; i < n; ++i) {
+            a[i * n + j] = col[i];
+        }
+    }
+}
+
+// Number of sweeps between checks of tracked energy and magnetisation.
+constexpr int check_interval = 1000;
+
+} // namespace
+
 std::array<double, 4> Chem::Ising2D::metropolis(double temp, int mc_trials)
+{
+    auto res = sample(temp, mc_trials, &Ising2D::mc_spin_flip);
+    return {res[0], res[1], res[2], res[3]};
+}
+
+std::array<double, 6> Chem::Ising2D::wolff(double temp, int mc_trials)
+{
+    return sample(temp, mc_trials, &Ising2D::wolff_update);
+}
+
+std::array<double, 6> Chem::Ising2D::swendsen_wang(double temp, int mc_trials)
+{
+    return sample(temp, mc_trials, &Ising2D::sw_update);
+}
+
+std::array<double, 6> Chem::Ising2D::sample(double temp,
+                                            int mc_trials,
+                                            void (Ising2D::*update)(double))
 {
     // Initialise variables:
     double beta = 1.0 / temp;
@@ -23,19 +213,35 @@ std::array<double, 4> Chem::Ising2D::metropolis(double temp, int mc_trials)
     double m1 = 0.0;
     double m2 = 0.0;
 
+    std::vector<double> e_series(mc_trials);
+    std::vector<double> m_series(mc_trials);
+
+    compute_energy_magn();
+
+    sfac = Numlib::zeros<Numlib::Mat<double>>(size, size);
+    ncorr = 0;
+
     // Perform equilibration:
     for (int it = 0; it < mc_trials; ++it) {
-        mc_spin_flip(beta);
+        (this->*update)(beta);
     }
     // Perform Monte Carlo sampling:
     for (int it = 0; it < mc_trials; ++it) {
-        mc_spin_flip(beta);
-        compute_energy_magn();
+        (this->*update)(beta);
+        if ((it + 1) % check_interval == 0) {
+            check_energy_magn();
+        }
+        set_energy_magn();
         visualize_if_requested(temp, it);
+        if (corr_stride > 0 && (it + 1) % corr_stride == 0) {
+            measure_corr();
+        }
         e1 += energy;
-        m1 += magn;
+        m1 += std::abs(magn);
         e2 += energy * energy;
         m2 += magn * magn;
+        e_series[it] = energy;
+        m_series[it] = std::abs(magn);
     }
     // Normalise average values:
     e1 /= static_cast<double>(mc_trials);
@@ -43,73 +249,318 @@ std::array<double, 4> Chem::Ising2D::metropolis(double temp, int mc_trials)
     m1 /= static_cast<double>(mc_trials);
     m2 /= static_cast<double>(mc_trials);
 
+    if (ncorr > 0) {
+        for (auto& sk : sfac) {
+            sk /= ncorr;
+        }
+    }
+
     double n2 = static_cast<double>(size * size);
     double e_avg = e1 / n2;
     double m_avg = m1 / n2;
     double c_avg = beta * beta * (e2 - e1 * e1) / n2;
     double x_avg = beta * (m2 - m1 * m1) / n2;
 
-    return {e_avg, m_avg, c_avg, x_avg};
+    return {e_avg,
+            m_avg,
+            c_avg,
+            x_avg,
+            autocorr_time(e_series),
+            autocorr_time(m_series)};
+}
+
+Numlib::Mat<double> Chem::Ising2D::correlation() const
+{
+    // S(k) = S(-k), hence G(r) = sum_k S(k) exp(i k r) / N is real:
+    const int n2 = size * size;
+    std::vector<std::complex<double>> a(sfac.begin(), sfac.end());
+    fft2(a, size, 1);
+
+    auto g = Numlib::zeros<Numlib::Mat<double>>(size, size);
+    for (int i = 0; i < n2; ++i) {
+        g.data()[i] = a[i].real() / n2;
+    }
+    return g;
+}
+
+double Chem::Ising2D::correlation_length() const
+{
+    Assert::dynamic(ncorr > 0, "structure factor has not been measured");
+
+    const double s0 = sfac(0, 0);
+    const double s1 = 0.5 * (sfac(0, 1) + sfac(1, 0));
+    if (size < 2 || s1 <= 0.0 || s0 <= s1) {
+        return 0.0;
+    }
+    const double pi = Numlib::Constants::pi;
+    return std::sqrt(s0 / s1 - 1.0) / (2.0 * std::sin(pi / size));
+}
+
+void Chem::Ising2D::measure_corr()
+{
+    const int n2 = size * size;
+    std::vector<std::complex<double>> a(spins.begin(), spins.end());
+    fft2(a, size, -1);
+
+    for (int i = 0; i < n2; ++i) {
+        sfac.data()[i] += std::norm(a[i]) / n2;
+    }
+    ++ncorr;
 }
 
 void Chem::Ising2D::mc_spin_flip(double beta)
 {
-    std::uniform_int_distribution<> rnd_int_uni(0, size - 1);
-    std::uniform_real_distribution<> rnd_real_uni(0.0, 1.0);
+    // Acceptance probabilities for each spin and sum of neighbour spins:
+    std::array<double, 10> prob;
+    for (int k = 0; k < 10; ++k) {
+        const int st = k < 5 ? -1 : 1;
+        const int s_nb = 2 * (k % 5) - 4;
+        const double ediff = 2.0 * bfield * st + 2.0 * jint * st * s_nb;
+        prob[k] = ediff < 0.0 ? 1.0 : std::exp(-ediff * beta);
+    }
+
+    int* s = spins.data();
+    const std::uint64_t n = sweep++;
+
+    // Changes of bond and spin sums from accepted flips:
+    long long dbond = 0;
+    long long dspin = 0;
+
+    for (int color = 0; color < 2; ++color) {
+#pragma omp parallel for if (size % 2 == 0) reduction(+ : dbond, dspin)
+        for (int i = 0; i < size; ++i) {
+            int* row = s + i * size;
+            const int* up = s + pbc(i - 1) * size;
+            const int* down = s + pbc(i + 1) * size;
+            for (int j = (i + color) % 2; j < size; j += 2) {
+                const int st = row[j];
+                const int s_nb = row[j == 0 ? size - 1 : j - 1] +
+                                 row[j == size - 1 ? 0 : j + 1] + up[j] +
+                                 down[j];
+
+                // Check for acceptance; flip spin if accepted:
+                const double p = prob[(st + 1) / 2 * 5 + (s_nb + 4) / 2];
+                bool accept = p >= 1.0;
+                if (!accept) {
+                    const auto site = static_cast<std::uint64_t>(i) * size + j;
+                    accept = rng.uniform(site, n) < p;
+                }
+                if (accept) {
+                    row[j] = -st;
+                    dbond -= 2 * st * s_nb;
+                    dspin -= 2 * st;
+                }
+            }
+        }
+    }
+    bond_sum += dbond;
+    spin_sum += dspin;
+}
+
+void Chem::Ising2D::wolff_update(double beta)
+{
+    const double padd = 1.0 - std::exp(-2.0 * beta * std::abs(jint));
+    const int n2 = size * size;
 
-    for (int it = 0; it < size * size; ++it) {
-        int i = rnd_int_uni(mt);
-        int j = rnd_int_uni(mt);
+    int* s = spins.data();
+    std::vector<char> in_cluster(n2, 0);
+    std::vector<int> cluster;
 
-        auto st = spins(i, j);
-        auto s_nb = spins(i, pbc(j - 1)) + spins(i, pbc(j + 1)) +
-                    spins(pbc(i - 1), j) + spins(pbc(i + 1), j);
+    int visited = 0;
+    while (visited < n2) {
+        const std::uint64_t n = sweep++;
+        std::uint64_t draw = 0;
 
-        // Compute energy change:
-        double ediff = 2.0 * bfield * st + 2.0 * jint * st * s_nb;
+        // Grow cluster from random seed site:
+        int seed = static_cast<int>(rng.uniform(draw++, n) * n2);
+        cluster.assign(1, seed);
+        in_cluster[seed] = 1;
+        int ssum = 0;
+        for (std::size_t c = 0; c < cluster.size(); ++c) {
+            const int site = cluster[c];
+            const int i = site / size;
+            const int j = site % size;
+            const int nb[4] = {i * size + pbc(j - 1), i * size + pbc(j + 1),
+                               pbc(i - 1) * size + j, pbc(i + 1) * size + j};
+            ssum += s[site];
+            for (int k : nb) {
+                if (!in_cluster[k] && jint * s[site] * s[k] > 0.0 &&
+                    rng.uniform(draw++, n) < padd) {
+                    in_cluster[k] = 1;
+                    cluster.push_back(k);
+                }
+            }
+        }
+        visited += static_cast<int>(cluster.size());
 
-        // Check for acceptance; flip spin if accepted:
-        if (ediff < 0.0) {
-            st *= -1;
+        // Flip cluster if accepted in external field; only bonds across
+        // the cluster boundary change:
+        const double ediff = 2.0 * bfield * ssum;
+        const bool accept =
+            ediff <= 0.0 || rng.uniform(draw++, n) < std::exp(-ediff * beta);
+        if (accept) {
+            long long bsum = 0;
+            for (int site : cluster) {
+                const int i = site / size;
+                const int j = site % size;
+                const int nb[4] = {i * size + pbc(j - 1),
+                                   i * size + pbc(j + 1),
+                                   pbc(i - 1) * size + j,
+                                   pbc(i + 1) * size + j};
+                for (int k : nb) {
+                    if (!in_cluster[k]) {
+                        bsum += s[site] * s[k];
+                    }
+                }
+            }
+            for (int site : cluster) {
+                s[site] = -s[site];
+            }
+            bond_sum -= 2 * bsum;
+            spin_sum -= 2 * ssum;
         }
-        else if (rnd_real_uni(mt) <= std::exp(-ediff * beta)) {
-            st *= -1;
+        for (int site : cluster) {
+            in_cluster[site] = 0;
+        }
+    }
+}
+
+void Chem::Ising2D::sw_update(double beta)
+{
+    const double padd = 1.0 - std::exp(-2.0 * beta * std::abs(jint));
+    const int n2 = size * size;
+    const std::uint64_t n = sweep++;
+
+    int* s = spins.data();
+    std::vector<int> parent(n2);
+    std::iota(parent.begin(), parent.end(), 0);
+
+    // Activate bonds to right and lower neighbours and join clusters:
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            const int site = i * size + j;
+            const int nb[2] = {i * size + pbc(j + 1), pbc(i + 1) * size + j};
+            for (int k = 0; k < 2; ++k) {
+                const auto bond = 2 * static_cast<std::uint64_t>(site) + k;
+                if (jint * s[site] * s[nb[k]] > 0.0 &&
+                    rng.uniform(bond, n) < padd) {
+                    unite(parent, site, nb[k]);
+                }
+            }
+        }
+    }
+
+    // Flip each cluster with heat-bath probability in external field:
+    std::vector<int> ssum(n2, 0);
+    for (int site = 0; site < n2; ++site) {
+        ssum[find(parent, site)] += s[site];
+    }
+    std::vector<char> flip(n2, 0);
+    for (int site = 0; site < n2; ++site) {
+        if (parent[site] == site) {
+            const double ediff = 2.0 * bfield * ssum[site];
+            const auto draw = 2 * static_cast<std::uint64_t>(n2) + site;
+            const double p = 1.0 / (1.0 + std::exp(ediff * beta));
+            flip[site] = rng.uniform(draw, n) < p;
+            if (flip[site]) {
+                spin_sum -= 2 * ssum[site];
+            }
+        }
+    }
+    for (int site = 0; site < n2; ++site) {
+        flip[site] = flip[find(parent, site)];
+    }
+
+    // Only bonds between flipped and unflipped clusters change:
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            const int site = i * size + j;
+            const int nb[2] = {i * size + pbc(j + 1), pbc(i + 1) * size + j};
+            for (int k : nb) {
+                if (flip[site] != flip[k]) {
+                    bond_sum -= 2 * s[site] * s[k];
+                }
+            }
+        }
+    }
+    for (int site = 0; site < n2; ++site) {
+        if (flip[site]) {
+            s[site] = -s[site];
         }
-        spins(i, j) = st;
     }
 }
 
 void Chem::Ising2D::compute_energy_magn()
 {
-    magn = magnetisation();
-    energy = 0.0;
-#pragma omp parallel for
+    // Integer sums are exact, hence independent of the number of threads:
+    long long bsum = 0;
+    long long msum = 0;
+#pragma omp parallel for reduction(+ : bsum, msum)
     for (int i = 0; i < size; ++i) {
         for (int j = 0; j < size; ++j) {
             auto sij = spins(i, j);
             auto s_nb = spins(i, pbc(j + 1)) + spins(pbc(i + 1), j);
-            energy -= sij * s_nb;
+            bsum += sij * s_nb;
+            msum += sij;
         }
     }
-    energy *= jint;
-    energy -= bfield * magn;
+    bond_sum = bsum;
+    spin_sum = msum;
+    set_energy_magn();
 }
 
-void Chem::Ising2D::visualize_if_requested(double temp, int it) const
+void Chem::Ising2D::check_energy_magn()
 {
-    for (auto& vi : viz) {
-        if (vi == it) {
-            std::string fname = "ising_T" + std::to_string(temp) + "_N" +
-                                std::to_string(it) + ".csv";
-            std::ofstream to;
-            Stdutils::fopen(to, fname);
+    const long long bsum = bond_sum;
+    const long long msum = spin_sum;
+    compute_energy_magn();
+    Assert::dynamic(bsum == bond_sum && msum == spin_sum,
+                    "tracked energy or magnetisation is wrong");
+}
 
-            for (int i = 0; i < size; ++i) {
-                for (int j = 0; j < size - 1; ++j) {
-                    to << spins(i, j) << ",";
-                }
-                to << spins(i, size - 1) << std::endl;
-            }
+void Chem::Ising2D::visualize_if_requested(double temp, int it)
+{
+    if (std::binary_search(viz.begin(), viz.end(), it)) {
+        if (!snap) {
+            snap.reset(new Snapshot_writer(snap_file, size, size));
         }
+        snap->write(temp, it, pack_spins(size, size, [&](int i, int j) {
+                        return spins(i, j);
+                    }));
+    }
+}
+
+double Chem::autocorr_time(const std::vector<double>& x, double c)
+{
+    const std::size_t n = x.size();
+    if (n < 2) {
+        return 0.5;
+    }
+    double mean = 0.0;
+    for (auto xi : x) {
+        mean += xi;
     }
-}
\ No newline at end of file
+    mean /= static_cast<double>(n);
+
+    double c0 = 0.0;
+    for (auto xi : x) {
+        c0 += (xi - mean) * (xi - mean);
+    }
+    c0 /= static_cast<double>(n);
+    if (c0 == 0.0) {
+        return 0.5;
+    }
+
+    double tau = 0.5;
+    for (std::size_t t = 1; t < n; ++t) {
+        double ct = 0.0;
+        for (std::size_t i = 0; i < n - t; ++i) {
+            ct += (x[i] - mean) * (x[i + t] - mean);
+        }
+        tau += ct / (static_cast<double>(n - t) * c0);
+        if (static_cast<double>(t) >= c * tau) {
+            break;
+        }
+    }
+    return tau;
+}
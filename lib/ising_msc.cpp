@@ -0,0 +1,284 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/ising_msc.h>
+#include <stdutils/stdutils.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+
+namespace {
+
+inline int popcount(std::uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555);
+    x = (x & 0x3333333333333333) + ((x >> 2) & 0x3333333333333333);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0f;
+    return static_cast<int>((x * 0x0101010101010101) >> 56);
+#endif
+}
+
+// Count set bits in four words bitwise; the count (0 to 4) is returned
+// as one-hot masks.
+inline void count_bits(std::uint64_t a,
+                       std::uint64_t b,
+                       std::uint64_t c,
+                       std::uint64_t d,
+                       std::array<std::uint64_t, 5>& k)
+{
+    const std::uint64_t s1 = a ^ b;
+    const std::uint64_t c1 = a & b;
+    const std::uint64_t s2 = c ^ d;
+    const std::uint64_t c2 = c & d;
+    const std::uint64_t bit0 = s1 ^ s2;
+    const std::uint64_t bit1 = c1 ^ c2 ^ (s1 & s2);
+    const std::uint64_t bit2 = c1 & c2;
+
+    k[0] = ~(bit0 | bit1 | bit2);
+    k[1] = bit0 & ~bit1 & ~bit2;
+    k[2] = ~bit0 & bit1;
+    k[3] = bit0 & bit1;
+    k[4] = bit2;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+Chem::Ising2D_msc::Ising2D_msc(
+    int sz, double j, double b, const std::vector<int>& v, int seed)
+    : size(sz), jint(j), bfield(b), viz(v), snap_file("ising.snap"), sweep(0)
+{
+    Assert::dynamic(size > 0 && size % 128 == 0,
+                    "lattice size must be a multiple of 128");
+    std::sort(viz.begin(), viz.end());
+    nwords = size / 128;
+
+    if (seed == 0) {
+        std::random_device rd;
+        rng = Philox4x32((static_cast<std::uint64_t>(rd()) << 32) ^ rd());
+    }
+    else {
+        rng = Philox4x32(seed); // should only be used for testing
+    }
+    init_spins();
+}
+
+std::array<double, 4> Chem::Ising2D_msc::metropolis(double temp,
+                                                     int mc_trials)
+{
+    // Initialise variables:
+    double beta = 1.0 / temp;
+    double e1 = 0.0;
+    double e2 = 0.0;
+    double m1 = 0.0;
+    double m2 = 0.0;
+
+    set_acceptance(beta);
+
+    // Perform equilibration:
+    for (int it = 0; it < mc_trials; ++it) {
+        mc_spin_flip();
+    }
+    // Perform Monte Carlo sampling:
+    for (int it = 0; it < mc_trials; ++it) {
+        mc_spin_flip();
+        compute_energy_magn();
+        visualize_if_requested(temp, it);
+        e1 += energy;
+        m1 += std::abs(magn);
+        e2 += energy * energy;
+        m2 += magn * magn;
+    }
+    // Normalise average values:
+    e1 /= static_cast<double>(mc_trials);
+    e2 /= static_cast<double>(mc_trials);
+    m1 /= static_cast<double>(mc_trials);
+    m2 /= static_cast<double>(mc_trials);
+
+    double n2 = static_cast<double>(size) * size;
+    double e_avg = e1 / n2;
+    double m_avg = m1 / n2;
+    double c_avg = beta * beta * (e2 - e1 * e1) / n2;
+    double x_avg = beta * (m2 - m1 * m1) / n2;
+
+    return {e_avg, m_avg, c_avg, x_avg};
+}
+
+int Chem::Ising2D_msc::spin(int i, int j) const
+{
+    // Site (i, j) is site m = j / 2 of the sublattice of colour (i + j) % 2:
+    const int m = j / 2;
+    const auto w = lat[(i + j) % 2][i * nwords + m / 64];
+    return ((w >> (m % 64)) & 1) ? 1 : -1;
+}
+
+//------------------------------------------------------------------------------
+
+void Chem::Ising2D_msc::init_spins()
+{
+    for (auto& li : lat) {
+        li.assign(static_cast<std::size_t>(size) * nwords, ~std::uint64_t(0));
+    }
+}
+
+void Chem::Ising2D_msc::set_acceptance(double beta)
+{
+    // Energy change for flipping a spin with k antiparallel neighbours:
+    for (int idx = 0; idx < 10; ++idx) {
+        const int st = idx < 5 ? -1 : 1;
+        const int k = idx % 5;
+        const double ediff = 2.0 * bfield * st + 2.0 * jint * (4 - 2 * k);
+        const double p = std::exp(-ediff * beta);
+        always[idx] = ediff <= 0.0;
+        threshold[idx] =
+            always[idx] ? 0
+                        : static_cast<std::uint32_t>(
+                              std::min(std::ldexp(p, 32), 4294967295.0));
+    }
+}
+
+void Chem::Ising2D_msc::mc_spin_flip()
+{
+    const std::uint64_t n = sweep++;
+    update(0, n);
+    update(1, n);
+}
+
+void Chem::Ising2D_msc::update(int color, std::uint64_t n)
+{
+    std::uint64_t* cur = lat[color].data();
+    const std::uint64_t* oth = lat[1 - color].data();
+
+    const auto ctr2 = static_cast<std::uint32_t>(n);
+    const auto ctr3 = static_cast<std::uint32_t>(((n >> 32) << 9) |
+                                                 (color << 8));
+
+#pragma omp parallel for
+    for (int i = 0; i < size; ++i) {
+        const std::uint64_t* up = oth + pbc(i - 1) * nwords;
+        const std::uint64_t* down = oth + pbc(i + 1) * nwords;
+        std::array<std::uint64_t, 5> k;
+        std::array<std::uint64_t, 10> cls;
+
+        for (int w = 0; w < nwords; ++w) {
+            const std::size_t idx = static_cast<std::size_t>(i) * nwords + w;
+            const std::uint64_t s = cur[idx];
+
+            std::uint64_t nb1;
+            std::uint64_t nb2;
+            row_neighbours(color, i, w, nb1, nb2);
+            count_bits(s ^ nb1, s ^ nb2, s ^ up[w], s ^ down[w], k);
+
+            // Spins classified by value and number of antiparallel
+            // neighbours:
+            std::uint64_t accept = 0;
+            std::uint64_t undecided = 0;
+            for (int c = 0; c < 10; ++c) {
+                cls[c] = (c < 5 ? ~s : s) & k[c % 5];
+                if (always[c]) {
+                    accept |= cls[c];
+                }
+                else if (threshold[c] != 0) {
+                    undecided |= cls[c];
+                }
+            }
+
+            // Compare 32-bit random numbers, one per spin and drawn as bit
+            // planes from the most significant bit, with the thresholds:
+            for (std::uint32_t pair = 0; pair < 16 && undecided; ++pair) {
+                const auto r = rng({static_cast<std::uint32_t>(idx),
+                                    static_cast<std::uint32_t>(idx >> 32),
+                                    ctr2, ctr3 | pair});
+                const std::uint64_t rp[2] = {
+                    r[0] | static_cast<std::uint64_t>(r[1]) << 32,
+                    r[2] | static_cast<std::uint64_t>(r[3]) << 32};
+
+                for (int h = 0; h < 2; ++h) {
+                    const int bit = 31 - 2 * static_cast<int>(pair) - h;
+                    std::uint64_t tp = 0;
+                    for (int c = 0; c < 10; ++c) {
+                        if ((threshold[c] >> bit) & 1) {
+                            tp |= cls[c];
+                        }
+                    }
+                    accept |= undecided & ~rp[h] & tp;
+                    undecided &= ~(rp[h] ^ tp);
+                }
+            }
+            cur[idx] = s ^ accept;
+        }
+    }
+}
+
+void Chem::Ising2D_msc::row_neighbours(int color,
+                                       int i,
+                                       int w,
+                                       std::uint64_t& nb1,
+                                       std::uint64_t& nb2) const
+{
+    // Site m of a sublattice row is at column j = 2 m + o, where o is the
+    // offset of the row. Its neighbours in the same row are sites m and
+    // m - 1 of the other sublattice if o is 0, and sites m and m + 1 if o
+    // is 1:
+    const std::uint64_t* row = lat[1 - color].data() + i * nwords;
+    nb1 = row[w];
+    if ((i + color) % 2 == 0) {
+        const int wp = w == 0 ? nwords - 1 : w - 1;
+        nb2 = (row[w] << 1) | (row[wp] >> 63);
+    }
+    else {
+        const int wn = w == nwords - 1 ? 0 : w + 1;
+        nb2 = (row[w] >> 1) | (row[wn] << 63);
+    }
+}
+
+void Chem::Ising2D_msc::compute_energy_magn()
+{
+    // Each bond joins the two sublattices; the antiparallel bonds are
+    // counted from the sites of sublattice 0:
+    const std::uint64_t* s0 = lat[0].data();
+    const std::uint64_t* s1 = lat[1].data();
+
+    long long anti = 0;
+    long long up = 0;
+#pragma omp parallel for reduction(+ : anti, up)
+    for (int i = 0; i < size; ++i) {
+        const std::uint64_t* above = s1 + pbc(i - 1) * nwords;
+        const std::uint64_t* below = s1 + pbc(i + 1) * nwords;
+        for (int w = 0; w < nwords; ++w) {
+            const std::size_t idx = static_cast<std::size_t>(i) * nwords + w;
+            const std::uint64_t s = s0[idx];
+
+            std::uint64_t nb1;
+            std::uint64_t nb2;
+            row_neighbours(0, i, w, nb1, nb2);
+            anti += popcount(s ^ nb1) + popcount(s ^ nb2) +
+                    popcount(s ^ above[w]) + popcount(s ^ below[w]);
+            up += popcount(s) + popcount(s1[idx]);
+        }
+    }
+    const double n2 = static_cast<double>(size) * size;
+    magn = 2.0 * static_cast<double>(up) - n2;
+    energy = -jint * (2.0 * n2 - 2.0 * static_cast<double>(anti)) -
+             bfield * magn;
+}
+
+void Chem::Ising2D_msc::visualize_if_requested(double temp, int it)
+{
+    if (std::binary_search(viz.begin(), viz.end(), it)) {
+        if (!snap) {
+            snap.reset(new Snapshot_writer(snap_file, size, size));
+        }
+        snap->write(temp, it, pack_spins(size, size, [&](int i, int j) {
+                        return spin(i, j);
+                    }));
+    }
+}
@@ -0,0 +1,243 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/ising_pt.h>
+#include <stdutils/stdutils.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace {
+
+// Compute log(sum(exp(x))) without overflow.
+double log_sum_exp(const std::vector<double>& x)
+{
+    double xmax = -std::numeric_limits<double>::infinity();
+    for (auto xi : x) {
+        xmax = std::max(xmax, xi);
+    }
+    double sum = 0.0;
+    for (auto xi : x) {
+        sum += std::exp(xi - xmax);
+    }
+    return xmax + std::log(sum);
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+Chem::Ising2D_pt::Ising2D_pt(
+    int sz, double j, double b, const std::vector<double>& t, int seed)
+    : size(sz), jint(j), bfield(b), temps(t), ntrials(0), sweep(0)
+{
+    Assert::dynamic(!temps.empty(), "no temperatures given");
+    std::sort(temps.begin(), temps.end());
+
+    for (std::size_t k = 0; k < temps.size(); ++k) {
+        int rseed = seed == 0 ? 0 : seed + static_cast<int>(k) + 1;
+        replicas.emplace_back(size, jint, bfield, std::vector<int>{}, rseed);
+        rep_at.push_back(static_cast<int>(k));
+    }
+    n_accept.assign(temps.size() - 1, 0);
+    n_trial.assign(temps.size() - 1, 0);
+
+    if (seed == 0) {
+        std::random_device rd;
+        rng = Philox4x32((static_cast<std::uint64_t>(rd()) << 32) ^ rd());
+    }
+    else {
+        rng = Philox4x32(seed); // should only be used for testing
+    }
+}
+
+std::vector<std::array<double, 4>> Chem::Ising2D_pt::tempering(int mc_trials)
+{
+    const int ntemps = static_cast<int>(temps.size());
+
+    // Perform one sweep of all replicas followed by exchanges:
+    auto step = [&]() {
+#pragma omp parallel for schedule(dynamic)
+        for (int k = 0; k < ntemps; ++k) {
+            replicas[rep_at[k]].metropolis_sweep(temps[k]);
+        }
+        exchange(static_cast<int>(sweep % 2));
+        ++sweep;
+    };
+
+    // Perform equilibration:
+    for (int it = 0; it < mc_trials; ++it) {
+        step();
+    }
+    std::fill(n_accept.begin(), n_accept.end(), 0);
+    std::fill(n_trial.begin(), n_trial.end(), 0);
+
+    // Perform Monte Carlo sampling:
+    std::vector<std::array<double, 4>> sums(ntemps, {0.0, 0.0, 0.0, 0.0});
+    hist.clear();
+    for (int it = 0; it < mc_trials; ++it) {
+        step();
+        for (int k = 0; k < ntemps; ++k) {
+            const auto& rep = replicas[rep_at[k]];
+            const long long bsum = rep.get_bond_sum();
+            const long long msum = rep.get_spin_sum();
+
+            hist[{bsum, msum}]++;
+
+            const double e = rep.get_energy(bsum, msum);
+            const double m = static_cast<double>(msum);
+            sums[k][0] += e;
+            sums[k][1] += std::abs(m);
+            sums[k][2] += e * e;
+            sums[k][3] += m * m;
+        }
+    }
+    ntrials = mc_trials;
+    lng.clear(); // histogram equations are solved on first reweighting
+
+    // Normalise average values:
+    std::vector<std::array<double, 4>> res(ntemps);
+    const double n2 = static_cast<double>(size) * size;
+    for (int k = 0; k < ntemps; ++k) {
+        const double beta = 1.0 / temps[k];
+        const double e1 = sums[k][0] / mc_trials;
+        const double m1 = sums[k][1] / mc_trials;
+        const double e2 = sums[k][2] / mc_trials;
+        const double m2 = sums[k][3] / mc_trials;
+        res[k] = {e1 / n2, m1 / n2, beta * beta * (e2 - e1 * e1) / n2,
+                  beta * (m2 - m1 * m1) / n2};
+    }
+    return res;
+}
+
+std::array<double, 4> Chem::Ising2D_pt::reweight(double temp) const
+{
+    Assert::dynamic(!hist.empty(), "no histograms to reweight");
+    if (lng.empty()) {
+        solve_histograms();
+    }
+
+    // Boltzmann weights relative to the largest weight:
+    const double beta = 1.0 / temp;
+    std::vector<double> lnw(lng.size());
+    for (std::size_t l = 0; l < lng.size(); ++l) {
+        lnw[l] = lng[l] - beta * ener[l];
+    }
+    const double lnz = log_sum_exp(lnw);
+
+    double e1 = 0.0;
+    double e2 = 0.0;
+    double m1 = 0.0;
+    double m2 = 0.0;
+    for (std::size_t l = 0; l < lng.size(); ++l) {
+        const double w = std::exp(lnw[l] - lnz);
+        e1 += w * ener[l];
+        e2 += w * ener[l] * ener[l];
+        m1 += w * std::abs(magn[l]);
+        m2 += w * magn[l] * magn[l];
+    }
+    const double n2 = static_cast<double>(size) * size;
+    return {e1 / n2, m1 / n2, beta * beta * (e2 - e1 * e1) / n2,
+            beta * (m2 - m1 * m1) / n2};
+}
+
+std::vector<double> Chem::Ising2D_pt::exchange_rates() const
+{
+    std::vector<double> rates(n_trial.size(), 0.0);
+    for (std::size_t k = 0; k < rates.size(); ++k) {
+        if (n_trial[k] > 0) {
+            rates[k] = static_cast<double>(n_accept[k]) / n_trial[k];
+        }
+    }
+    return rates;
+}
+
+//------------------------------------------------------------------------------
+
+void Chem::Ising2D_pt::exchange(int parity)
+{
+    const int ntemps = static_cast<int>(temps.size());
+    for (int k = parity; k < ntemps - 1; k += 2) {
+        const auto& ri = replicas[rep_at[k]];
+        const auto& rj = replicas[rep_at[k + 1]];
+        const double ei = ri.get_energy(ri.get_bond_sum(), ri.get_spin_sum());
+        const double ej = rj.get_energy(rj.get_bond_sum(), rj.get_spin_sum());
+        const double delta = (1.0 / temps[k] - 1.0 / temps[k + 1]) * (ei - ej);
+
+        n_trial[k]++;
+        if (delta >= 0.0 ||
+            rng.uniform(static_cast<std::uint64_t>(k), sweep) <
+                std::exp(delta)) {
+            std::swap(rep_at[k], rep_at[k + 1]);
+            n_accept[k]++;
+        }
+    }
+}
+
+void Chem::Ising2D_pt::solve_histograms() const
+{
+    // Self-consistent equations for the density of states g and the free
+    // energies f of each temperature:
+    //
+    //     g(E) = H(E) / sum_k N_k exp(f_k - beta_k E)
+    //     exp(-f_k) = sum_E g(E) exp(-beta_k E)
+
+    const std::size_t ntemps = temps.size();
+    const std::size_t nlevels = hist.size();
+
+    ener.resize(nlevels);
+    magn.resize(nlevels);
+    lng.resize(nlevels);
+    std::vector<double> lnh(nlevels);
+
+    std::size_t l = 0;
+    for (const auto& h : hist) {
+        ener[l] = replicas[0].get_energy(h.first.first, h.first.second);
+        magn[l] = static_cast<double>(h.first.second);
+        lnh[l] = std::log(static_cast<double>(h.second));
+        ++l;
+    }
+
+    const double lnn = std::log(static_cast<double>(ntrials));
+    std::vector<double> f(ntemps, 0.0);
+    std::vector<double> fnew(ntemps);
+    std::vector<double> xk(ntemps);
+    std::vector<double> xl(nlevels);
+
+    const double tol = 1.0e-8;
+    const int maxiter = 10000;
+    bool converged = false;
+    for (int iter = 0; iter < maxiter && !converged; ++iter) {
+        for (l = 0; l < nlevels; ++l) {
+            for (std::size_t k = 0; k < ntemps; ++k) {
+                xk[k] = lnn + f[k] - ener[l] / temps[k];
+            }
+            lng[l] = lnh[l] - log_sum_exp(xk);
+        }
+        for (std::size_t k = 0; k < ntemps; ++k) {
+            for (l = 0; l < nlevels; ++l) {
+                xl[l] = lng[l] - ener[l] / temps[k];
+            }
+            fnew[k] = -log_sum_exp(xl);
+        }
+
+        // Free energies are relative to the lowest temperature:
+        const double f0 = fnew[0];
+        double diff = 0.0;
+        for (std::size_t k = 0; k < ntemps; ++k) {
+            fnew[k] -= f0;
+            diff = std::max(diff, std::abs(fnew[k] - f[k]));
+        }
+        f.swap(fnew);
+        converged = diff < tol;
+    }
+    if (!converged) {
+        lng.clear(); // solve again on next call
+    }
+    Assert::dynamic(converged,
+                    "multiple-histogram equations did not converge");
+}
@@ -0,0 +1,224 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/ising_snapshot.h>
+#include <stdutils/stdutils.h>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char magic_head[] = "CHEMSNP1";
+const char magic_tail[] = "CHEMSNPI";
+
+template <typename T>
+void write_value(std::ostream& to, const T& value)
+{
+    to.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void read_value(std::istream& from, T& value)
+{
+    from.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+// Get size of frame with packed spins.
+inline std::uint64_t frame_size(int rows, int cols)
+{
+    return sizeof(double) + sizeof(std::int32_t) + (rows * cols + 7) / 8;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+Chem::Snapshot_writer::Snapshot_writer(const std::string& filename,
+                                       int rows,
+                                       int cols,
+                                       std::size_t max_queued_)
+    : nrows(rows), ncols(cols), max_queued(max_queued_), done(false)
+{
+    Assert::dynamic(rows > 0 && cols > 0, "bad snapshot size");
+    Assert::dynamic(max_queued > 0, "bad snapshot queue size");
+
+    Stdutils::fopen(to, filename, std::ios_base::out | std::ios_base::binary);
+    to.write(magic_head, 8);
+    write_value(to, static_cast<std::int32_t>(nrows));
+    write_value(to, static_cast<std::int32_t>(ncols));
+
+    worker = std::thread([this]() { run(); });
+}
+
+Chem::Snapshot_writer::~Snapshot_writer()
+{
+    try {
+        close();
+    }
+    catch (...) {
+        // errors are only reported by explicit close
+    }
+}
+
+void Chem::Snapshot_writer::write(double temp,
+                                  int it,
+                                  std::vector<std::uint8_t>&& spins)
+{
+    Assert::dynamic(spins.size() ==
+                        static_cast<std::size_t>(nrows * ncols + 7) / 8,
+                    "bad snapshot frame size");
+
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [&]() { return error || queue.size() < max_queued; });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    Assert::dynamic(!done, "snapshot file is closed");
+    queue.push_back({temp, it, std::move(spins)});
+    cv.notify_all();
+}
+
+void Chem::Snapshot_writer::close()
+{
+    if (!worker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        done = true;
+    }
+    cv.notify_all();
+    worker.join();
+
+    if (!error) {
+        // Write index:
+        const std::uint64_t index_pos = static_cast<std::uint64_t>(to.tellp());
+        for (auto pos : offsets) {
+            write_value(to, pos);
+        }
+        write_value(to, static_cast<std::uint64_t>(offsets.size()));
+        write_value(to, index_pos);
+        to.write(magic_tail, 8);
+        to.close();
+        if (to.fail()) {
+            error = std::make_exception_ptr(
+                std::runtime_error("could not write snapshot index"));
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void Chem::Snapshot_writer::run()
+{
+    try {
+        while (true) {
+            Frame frame;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&]() { return done || !queue.empty(); });
+                if (queue.empty()) {
+                    break;
+                }
+                frame = std::move(queue.front());
+                queue.pop_front();
+                cv.notify_all();
+            }
+            offsets.push_back(static_cast<std::uint64_t>(to.tellp()));
+            write_value(to, frame.temp);
+            write_value(to, static_cast<std::int32_t>(frame.it));
+            to.write(reinterpret_cast<const char*>(frame.spins.data()),
+                     static_cast<std::streamsize>(frame.spins.size()));
+            if (to.fail()) {
+                throw std::runtime_error("could not write snapshot");
+            }
+        }
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(mtx);
+        error = std::current_exception();
+        cv.notify_all();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+Chem::Snapshot_reader::Snapshot_reader(const std::string& filename)
+{
+    Stdutils::fopen(from, filename, std::ios_base::in | std::ios_base::binary);
+
+    char magic[8];
+    from.read(magic, 8);
+    std::int32_t rows = 0;
+    std::int32_t cols = 0;
+    read_value(from, rows);
+    read_value(from, cols);
+    if (!from || std::memcmp(magic, magic_head, 8) != 0 || rows <= 0 ||
+        cols <= 0) {
+        throw std::runtime_error(filename + " is not a snapshot file");
+    }
+    nrows = rows;
+    ncols = cols;
+
+    const std::uint64_t head = 8 + 2 * sizeof(std::int32_t);
+    from.seekg(0, std::ios_base::end);
+    const auto end = static_cast<std::uint64_t>(from.tellg());
+
+    // Read index if the file was closed:
+    const std::uint64_t tail = 2 * sizeof(std::uint64_t) + 8;
+    if (end >= head + tail) {
+        std::uint64_t nframes = 0;
+        std::uint64_t index_pos = 0;
+        from.seekg(end - tail);
+        read_value(from, nframes);
+        read_value(from, index_pos);
+        from.read(magic, 8);
+        if (from && std::memcmp(magic, magic_tail, 8) == 0 &&
+            index_pos + nframes * sizeof(std::uint64_t) == end - tail) {
+            offsets.resize(nframes);
+            from.seekg(index_pos);
+            for (auto& pos : offsets) {
+                read_value(from, pos);
+            }
+            return;
+        }
+    }
+
+    // Otherwise, take all complete frames:
+    from.clear();
+    const auto fsize = frame_size(nrows, ncols);
+    for (std::uint64_t pos = head; pos + fsize <= end; pos += fsize) {
+        offsets.push_back(pos);
+    }
+}
+
+void Chem::Snapshot_reader::read(std::size_t k,
+                                 double& temp,
+                                 int& it,
+                                 std::vector<int>& spins)
+{
+    Assert::dynamic(k < offsets.size(), "bad snapshot frame");
+
+    from.clear();
+    from.seekg(offsets[k]);
+    std::int32_t iter = 0;
+    read_value(from, temp);
+    read_value(from, iter);
+    it = iter;
+
+    const int n = nrows * ncols;
+    std::vector<std::uint8_t> bits((n + 7) / 8);
+    from.read(reinterpret_cast<char*>(bits.data()),
+              static_cast<std::streamsize>(bits.size()));
+    if (!from) {
+        throw std::runtime_error("could not read snapshot frame");
+    }
+    spins.resize(n);
+    for (int i = 0; i < n; ++i) {
+        spins[i] = (bits[i / 8] >> (i % 8)) & 1 ? 1 : -1;
+    }
+}
@@ -0,0 +1,362 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/ising_wl.h>
+#include <stdutils/stdutils.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace {
+
+// Compute log(sum(exp(x))) without overflow.
+double log_sum_exp(const std::vector<double>& x)
+{
+    double xmax = -std::numeric_limits<double>::infinity();
+    for (auto xi : x) {
+        xmax = std::max(xmax, xi);
+    }
+    double sum = 0.0;
+    for (auto xi : x) {
+        sum += std::exp(xi - xmax);
+    }
+    return xmax + std::log(sum);
+}
+
+// Get random number in [0, 1) from two 32-bit random numbers.
+inline double to_uniform(std::uint32_t r0, std::uint32_t r1)
+{
+    const std::uint64_t x =
+        (static_cast<std::uint64_t>(r0) << 21) ^ (r1 >> 11);
+    return static_cast<double>(x) * (1.0 / 9007199254740992.0);
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+Chem::Ising2D_wl::Ising2D_wl(
+    int sz, double j, int nwin, double overlap, int seed)
+    : size(sz), jint(j), sweep(0)
+{
+    Assert::dynamic(size >= 4, "lattice size must be at least 4");
+    Assert::dynamic(jint != 0.0, "interaction must be non-zero");
+    Assert::dynamic(nwin >= 1, "bad number of windows");
+    Assert::dynamic(overlap > 0.0 && overlap < 1.0, "bad window overlap");
+
+    if (seed == 0) {
+        std::random_device rd;
+        rng = Philox4x32((static_cast<std::uint64_t>(rd()) << 32) ^ rd());
+    }
+    else {
+        rng = Philox4x32(seed); // should only be used for testing
+    }
+
+    // Bond sums range from 2N to -2N in steps of 4; the level of a bond sum
+    // counts the steps from 2N. Windows of equal width are spread over the
+    // reachable levels:
+    const int nlevels = num_levels();
+    const double width = nlevels / (nwin - (nwin - 1) * overlap);
+    Assert::dynamic(width * overlap >= 2.0, "window overlap is too small");
+
+    windows.resize(nwin);
+    walkers.resize(nwin);
+    for (int w = 0; w < nwin; ++w) {
+        auto& win = windows[w];
+        win.kmin = static_cast<int>(std::round(w * width * (1.0 - overlap)));
+        win.kmax = w == nwin - 1 ? nlevels - 1
+                                 : static_cast<int>(win.kmin + width) - 1;
+        const std::size_t nk = win.kmax - win.kmin + 1;
+        win.lng.assign(nk, 0.0);
+        win.hist.assign(nk, 0);
+        win.visited.assign(nk, 0);
+        win.count.assign(nk, 0);
+        win.mabs.assign(nk, 0.0);
+        win.m2.assign(nk, 0.0);
+        win.moves = 0;
+        win.done = false;
+        init_walker(w);
+    }
+}
+
+void Chem::Ising2D_wl::wang_landau(double lnf_final, double flatness)
+{
+    const int nwin = static_cast<int>(windows.size());
+    for (auto& win : windows) {
+        win.lnf = 1.0;
+        win.one_over_t = false;
+        win.done = false;
+        win.steps = 0;
+    }
+
+    bool done = false;
+    while (!done) {
+#pragma omp parallel for schedule(dynamic)
+        for (int w = 0; w < nwin; ++w) {
+            auto& win = windows[w];
+            const bool flat = walk(w, flatness);
+            if (win.done) {
+                continue;
+            }
+            const double nk = static_cast<double>(win.lng.size());
+            const double lnf_t = nk / static_cast<double>(win.steps);
+            bool new_stage = false;
+            if (!win.one_over_t && flat) {
+                win.lnf /= 2.0;
+                win.one_over_t = win.lnf < lnf_t;
+                std::fill(win.hist.begin(), win.hist.end(), 0);
+                new_stage = true;
+            }
+            if (win.one_over_t) {
+                win.lnf = lnf_t;
+            }
+            win.done = win.lnf < lnf_final;
+
+            // Magnetisation is sampled from the start of the last stage:
+            if (new_stage && !win.done) {
+                std::fill(win.count.begin(), win.count.end(), 0);
+                std::fill(win.mabs.begin(), win.mabs.end(), 0.0);
+                std::fill(win.m2.begin(), win.m2.end(), 0.0);
+            }
+        }
+        exchange(static_cast<int>(sweep % 2));
+        ++sweep;
+
+        done = true;
+        for (const auto& win : windows) {
+            done = done && win.done;
+        }
+    }
+    join_windows();
+}
+
+std::vector<double> Chem::Ising2D_wl::energies() const
+{
+    std::vector<double> ener(levels.size());
+    for (std::size_t l = 0; l < levels.size(); ++l) {
+        ener[l] = -jint * static_cast<double>(levels[l]);
+    }
+    return ener;
+}
+
+std::array<double, 4> Chem::Ising2D_wl::thermo(double temp) const
+{
+    Assert::dynamic(!lng.empty(), "no density of states");
+
+    const double beta = 1.0 / temp;
+    const auto ener = energies();
+    std::vector<double> lnw(lng.size());
+    for (std::size_t l = 0; l < lng.size(); ++l) {
+        lnw[l] = lng[l] - beta * ener[l];
+    }
+    const double lnz = log_sum_exp(lnw);
+
+    double e1 = 0.0;
+    double e2 = 0.0;
+    double m1 = 0.0;
+    double msq = 0.0;
+    for (std::size_t l = 0; l < lng.size(); ++l) {
+        const double p = std::exp(lnw[l] - lnz);
+        e1 += p * ener[l];
+        e2 += p * ener[l] * ener[l];
+        m1 += p * mabs[l];
+        msq += p * m2[l];
+    }
+    const double n2 = static_cast<double>(size) * size;
+    return {e1 / n2, m1 / n2, beta * beta * (e2 - e1 * e1) / n2,
+            beta * (msq - m1 * m1) / n2};
+}
+
+//------------------------------------------------------------------------------
+
+bool Chem::Ising2D_wl::walk(int w, double flatness)
+{
+    auto& win = windows[w];
+    auto& x = walkers[w];
+    const int n2 = size * size;
+
+    int k = level(x.bond_sum);
+    for (int it = 0; it < n2; ++it) {
+        const std::uint64_t n = win.moves++;
+        const auto r = rng({static_cast<std::uint32_t>(n),
+                            static_cast<std::uint32_t>(n >> 32),
+                            static_cast<std::uint32_t>(w), 1});
+        const int site = static_cast<int>(
+            (static_cast<std::uint64_t>(r[0]) * n2) >> 32);
+        const int s_nb = neighbours(x, site);
+        const int knew = k + x.spins[site] * s_nb / 2;
+
+        if (knew >= win.kmin && knew <= win.kmax) {
+            const double dlng =
+                win.lng[k - win.kmin] - win.lng[knew - win.kmin];
+            if (dlng >= 0.0 || to_uniform(r[1], r[2]) < std::exp(dlng)) {
+                flip(x, site, s_nb);
+                k = knew;
+            }
+        }
+
+        const int i = k - win.kmin;
+        if (!win.done) {
+            win.lng[i] += win.lnf;
+            win.hist[i]++;
+        }
+        win.visited[i] = 1;
+        win.count[i]++;
+        win.mabs[i] += std::abs(static_cast<double>(x.spin_sum));
+        win.m2[i] += static_cast<double>(x.spin_sum) * x.spin_sum;
+    }
+    win.steps += n2;
+
+    // Check if histogram is flat over visited levels:
+    long long hmin = std::numeric_limits<long long>::max();
+    long long hsum = 0;
+    int nvisited = 0;
+    for (std::size_t i = 0; i < win.hist.size(); ++i) {
+        if (win.visited[i]) {
+            hmin = std::min(hmin, win.hist[i]);
+            hsum += win.hist[i];
+            ++nvisited;
+        }
+    }
+    return hmin > 0 && hmin >= flatness * hsum / nvisited;
+}
+
+void Chem::Ising2D_wl::init_walker(int w)
+{
+    auto& win = windows[w];
+    auto& x = walkers[w];
+    const int n2 = size * size;
+
+    // Start from the ground state and accept flips which do not move the
+    // energy away from the window:
+    x.spins.assign(n2, 1);
+    x.bond_sum = 2LL * n2;
+    x.spin_sum = n2;
+
+    // Give up after 1000 sweeps:
+    const std::uint64_t maxmoves = win.moves + 1000ULL * n2;
+    int k = 0;
+    while (k < win.kmin) {
+        Assert::dynamic(win.moves < maxmoves, "energy window is not reached");
+        const std::uint64_t n = win.moves++;
+        const auto r = rng({static_cast<std::uint32_t>(n),
+                            static_cast<std::uint32_t>(n >> 32),
+                            static_cast<std::uint32_t>(w), 0});
+        const int site = static_cast<int>(
+            (static_cast<std::uint64_t>(r[0]) * n2) >> 32);
+        const int s_nb = neighbours(x, site);
+        const int knew = k + x.spins[site] * s_nb / 2;
+        if (knew >= k && knew <= win.kmax) {
+            flip(x, site, s_nb);
+            k = knew;
+        }
+    }
+}
+
+void Chem::Ising2D_wl::exchange(int parity)
+{
+    const int nwin = static_cast<int>(windows.size());
+    for (int w = parity; w < nwin - 1; w += 2) {
+        const auto& wa = windows[w];
+        const auto& wb = windows[w + 1];
+        const int ka = level(walkers[w].bond_sum);
+        const int kb = level(walkers[w + 1].bond_sum);
+        if (ka < wb.kmin || kb > wa.kmax) {
+            continue; // not both in overlap
+        }
+        const double dlng = wa.lng[ka - wa.kmin] + wb.lng[kb - wb.kmin] -
+                            wa.lng[kb - wa.kmin] - wb.lng[ka - wb.kmin];
+        const auto r = rng({static_cast<std::uint32_t>(w),
+                            static_cast<std::uint32_t>(sweep),
+                            static_cast<std::uint32_t>(sweep >> 32), 2});
+        if (dlng >= 0.0 || to_uniform(r[0], r[1]) < std::exp(dlng)) {
+            std::swap(walkers[w], walkers[w + 1]);
+        }
+    }
+}
+
+void Chem::Ising2D_wl::join_windows()
+{
+    const int nlevels = num_levels();
+    std::vector<double> g(nlevels, 0.0);
+    std::vector<char> visited(nlevels, 0);
+
+    // Shift each window to match the previous one over their common
+    // levels, and take levels above the middle of the overlap from it:
+    for (std::size_t w = 0; w < windows.size(); ++w) {
+        const auto& win = windows[w];
+        double offset = 0.0;
+        int kstart = win.kmin;
+        if (w > 0) {
+            const int kend = windows[w - 1].kmax;
+            int ncommon = 0;
+            for (int k = win.kmin; k <= kend; ++k) {
+                if (visited[k] && win.visited[k - win.kmin]) {
+                    offset += g[k] - win.lng[k - win.kmin];
+                    ++ncommon;
+                }
+            }
+            Assert::dynamic(ncommon > 0, "windows do not overlap");
+            offset /= ncommon;
+            kstart = (win.kmin + kend + 1) / 2;
+        }
+        for (int k = kstart; k <= win.kmax; ++k) {
+            visited[k] = win.visited[k - win.kmin];
+            g[k] = win.lng[k - win.kmin] + offset;
+        }
+    }
+
+    // Magnetisation is averaged over all windows containing a level:
+    std::vector<long long> count(nlevels, 0);
+    std::vector<double> msum(nlevels, 0.0);
+    std::vector<double> m2sum(nlevels, 0.0);
+    for (const auto& win : windows) {
+        for (int k = win.kmin; k <= win.kmax; ++k) {
+            count[k] += win.count[k - win.kmin];
+            msum[k] += win.mabs[k - win.kmin];
+            m2sum[k] += win.m2[k - win.kmin];
+        }
+    }
+
+    levels.clear();
+    lng.clear();
+    mabs.clear();
+    m2.clear();
+    for (int k = 0; k < nlevels; ++k) {
+        if (visited[k]) {
+            levels.push_back(2LL * size * size - 4LL * k);
+            lng.push_back(g[k]);
+            mabs.push_back(count[k] > 0 ? msum[k] / count[k] : 0.0);
+            m2.push_back(count[k] > 0 ? m2sum[k] / count[k] : 0.0);
+        }
+    }
+
+    // Normalise to 2^N states:
+    const double lnsum = log_sum_exp(lng);
+    const double lnn = size * size * std::log(2.0);
+    for (auto& lg : lng) {
+        lg += lnn - lnsum;
+    }
+}
+
+void Chem::Ising2D_wl::flip(Walker& x, int site, int s_nb)
+{
+    const int s = x.spins[site];
+    x.spins[site] = -s;
+    x.bond_sum -= 2 * s * s_nb;
+    x.spin_sum -= 2 * s;
+}
+
+int Chem::Ising2D_wl::neighbours(const Walker& x, int site) const
+{
+    const int i = site / size;
+    const int j = site % size;
+    const int* s = x.spins.data();
+    return s[i * size + (j + size - 1) % size] + s[i * size + (j + 1) % size] +
+           s[((i + size - 1) % size) * size + j] +
+           s[((i + 1) % size) * size + j];
+}
@@ -0,0 +1,369 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/mapped_file.h>
+#include <algorithm>
+#include <clocale>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+inline bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' ||
+           c == '\f';
+}
+
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+// Exact powers of ten representable as doubles.
+const double pow10_exact[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                              1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                              1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                              1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Convert number in [first, last) by strtod, which is correctly rounded;
+// the number is copied with the decimal point of the current C locale.
+bool slow_parse_double(const char* first, const char* last, double& x)
+{
+    const char point = *std::localeconv()->decimal_point;
+
+    std::string tmp(first, last);
+    for (auto& c : tmp) {
+        if (c == '.') {
+            c = point;
+        }
+        else if (c == 'd' || c == 'D') {
+            c = 'e';
+        }
+    }
+    char* endp;
+    x = std::strtod(tmp.c_str(), &endp);
+    return endp == tmp.c_str() + tmp.size();
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+std::size_t Chem::Text_view::find(const char* pattern, std::size_t pos) const
+{
+    const std::size_t n = std::strlen(pattern);
+    if (pos > len || n > len - pos) {
+        return std::string::npos;
+    }
+    if (n == 0) {
+        return pos;
+    }
+    auto it = std::search(ptr + pos, ptr + len, pattern, pattern + n);
+    if (it == ptr + len) {
+        return std::string::npos;
+    }
+    return static_cast<std::size_t>(it - ptr);
+}
+
+Chem::Text_view Chem::Text_view::substr(std::size_t pos, std::size_t n) const
+{
+    if (pos > len) {
+        throw std::out_of_range("Text_view::substr");
+    }
+    return Text_view(ptr + pos, std::min(n, len - pos));
+}
+
+//------------------------------------------------------------------------------
+
+Chem::Mapped_file::Mapped_file(const std::string& filename)
+{
+    if (!open(filename)) {
+        throw std::runtime_error("cannot open " + filename);
+    }
+}
+
+#ifndef _WIN32
+
+bool Chem::Mapped_file::open(const std::string& filename)
+{
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+    len = static_cast<std::size_t>(st.st_size);
+    if (len > 0) {
+        void* addr = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            len = 0;
+            return false;
+        }
+        madvise(addr, len, MADV_SEQUENTIAL); // hint only
+        ptr = static_cast<const char*>(addr);
+        mapped = true;
+    }
+    ::close(fd); // the mapping stays valid
+    opened = true;
+    return true;
+}
+
+void Chem::Mapped_file::close()
+{
+    if (mapped) {
+        munmap(const_cast<char*>(ptr), len);
+    }
+    buf.clear();
+    ptr = nullptr;
+    len = 0;
+    opened = false;
+    mapped = false;
+}
+
+#else
+
+bool Chem::Mapped_file::open(const std::string& filename)
+{
+    close();
+
+    std::ifstream from(filename, std::ios_base::in | std::ios_base::binary);
+    if (!from) {
+        return false;
+    }
+    buf.assign(std::istreambuf_iterator<char>(from),
+               std::istreambuf_iterator<char>());
+    ptr = buf.data();
+    len = buf.size();
+    opened = true;
+    return true;
+}
+
+void Chem::Mapped_file::close()
+{
+    buf.clear();
+    ptr = nullptr;
+    len = 0;
+    opened = false;
+    mapped = false;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+bool Chem::Line_reader::next(Chem::Text_view& line)
+{
+    if (pos == last) {
+        return false;
+    }
+    auto eol = static_cast<const char*>(
+        std::memchr(pos, '\n', static_cast<std::size_t>(last - pos)));
+    const char* stop = eol ? eol : last;
+    const char* lend = stop;
+    if (lend > pos && *(lend - 1) == '\r') {
+        --lend;
+    }
+    line = Text_view(pos, static_cast<std::size_t>(lend - pos));
+    pos = eol ? eol + 1 : last;
+    return true;
+}
+
+bool Chem::Line_reader::prev(Chem::Text_view& line)
+{
+    if (pos == first) {
+        return false;
+    }
+    // Skip terminator of the preceding line:
+    const char* lend = pos;
+    if (*(lend - 1) == '\n') {
+        --lend;
+    }
+    const char* lbeg = lend;
+    while (lbeg > first && *(lbeg - 1) != '\n') {
+        --lbeg;
+    }
+    pos = lbeg;
+    if (lend > lbeg && *(lend - 1) == '\r') {
+        --lend;
+    }
+    line = Text_view(lbeg, static_cast<std::size_t>(lend - lbeg));
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+Chem::Text_view Chem::next_token(const char*& p, const char* end)
+{
+    while (p < end && is_space(*p)) {
+        ++p;
+    }
+    const char* start = p;
+    while (p < end && !is_space(*p)) {
+        ++p;
+    }
+    return Text_view(start, static_cast<std::size_t>(p - start));
+}
+
+Chem::Text_view Chem::get_token(Chem::Text_view text, int n)
+{
+    const char* p = text.begin();
+    Text_view tok;
+    for (int i = 0; i <= n; ++i) {
+        tok = next_token(p, text.end());
+        if (tok.empty()) {
+            break;
+        }
+    }
+    return tok;
+}
+
+bool Chem::parse_double(const char*& p, const char* end, double& x)
+{
+    const char* s = p;
+    while (s < end && is_space(*s)) {
+        ++s;
+    }
+    const char* first = s;
+
+    bool neg = false;
+    if (s < end && (*s == '-' || *s == '+')) {
+        neg = (*s == '-');
+        ++s;
+    }
+
+    // Accumulate up to 19 significant digits in an integer:
+    std::uint64_t mant = 0;
+    int ndig = 0;    // significant digits stored
+    int exp10 = 0;   // decimal exponent of the mantissa
+    bool any = false;
+    bool exact = true; // no digits dropped
+
+    while (s < end && is_digit(*s)) {
+        any = true;
+        if (ndig < 19) {
+            if (mant != 0 || *s != '0') {
+                ++ndig;
+            }
+            mant = 10 * mant + static_cast<std::uint64_t>(*s - '0');
+        }
+        else {
+            ++exp10;
+            exact = exact && (*s == '0');
+        }
+        ++s;
+    }
+    if (s < end && *s == '.') {
+        ++s;
+        while (s < end && is_digit(*s)) {
+            any = true;
+            if (ndig < 19) {
+                if (mant != 0 || *s != '0') {
+                    ++ndig;
+                }
+                mant = 10 * mant + static_cast<std::uint64_t>(*s - '0');
+                --exp10;
+            }
+            else {
+                exact = exact && (*s == '0');
+            }
+            ++s;
+        }
+    }
+    if (!any) {
+        return false;
+    }
+
+    // Exponent, either E or Fortran D:
+    if (s < end &&
+        (*s == 'e' || *s == 'E' || *s == 'd' || *s == 'D')) {
+        const char* t = s + 1;
+        bool eneg = false;
+        if (t < end && (*t == '-' || *t == '+')) {
+            eneg = (*t == '-');
+            ++t;
+        }
+        if (t < end && is_digit(*t)) {
+            int e = 0;
+            while (t < end && is_digit(*t)) {
+                if (e < 100000) {
+                    e = 10 * e + (*t - '0');
+                }
+                ++t;
+            }
+            exp10 += eneg ? -e : e;
+            s = t;
+        }
+    }
+
+    // Fast path if both mantissa and power of ten are exact doubles;
+    // otherwise, fall back to the correctly rounded strtod:
+    const std::uint64_t max_exact = std::uint64_t(1) << 53;
+    if (exact && mant <= max_exact && exp10 >= -22 && exp10 <= 22) {
+        double v = static_cast<double>(mant);
+        if (exp10 < 0) {
+            v /= pow10_exact[-exp10];
+        }
+        else {
+            v *= pow10_exact[exp10];
+        }
+        x = neg ? -v : v;
+    }
+    else if (!slow_parse_double(first, s, x)) {
+        return false;
+    }
+    p = s;
+    return true;
+}
+
+bool Chem::parse_int(const char*& p, const char* end, long& x)
+{
+    const char* s = p;
+    while (s < end && is_space(*s)) {
+        ++s;
+    }
+    bool neg = false;
+    if (s < end && (*s == '-' || *s == '+')) {
+        neg = (*s == '-');
+        ++s;
+    }
+    if (s == end || !is_digit(*s)) {
+        return false;
+    }
+    long v = 0;
+    while (s < end && is_digit(*s)) {
+        v = 10 * v + (*s - '0');
+        ++s;
+    }
+    x = neg ? -v : v;
+    p = s;
+    return true;
+}
+
+bool Chem::parse_double(Chem::Text_view text, double& x)
+{
+    const char* p = text.begin();
+    return parse_double(p, text.end(), x) && next_token(p, text.end()).empty();
+}
+
+bool Chem::parse_int(Chem::Text_view text, long& x)
+{
+    const char* p = text.begin();
+    return parse_int(p, text.end(), x) && next_token(p, text.end()).empty();
+}
@@ -4,6 +4,8 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <chem/cascade.h>
+#include <chem/forcefield.h>
 #include <chem/gaussian.h>
 #include <chem/mcmm.h>
 #include <chem/io.h>
@@ -19,20 +21,21 @@ Chem::Mcmm<Pot>::Mcmm(std::istream& from,
                       const Chem::Molecule& mol_,
                       const std::string& key,
                       bool verbose_)
-    : mol(mol_), verbose(verbose_)
+    : mol(mol_), conformers(mol_.atoms()), verbose(verbose_)
 {
     // Read input data:
 
     using namespace Stdutils;
 
     const double emin_def = -std::numeric_limits<double>::max();
+    const double emax_def = energy_max_default<Pot>();
 
     auto pos = find_token(from, key);
     if (pos != -1) {
         get_token_value(from, pos, "xtol", xtol, 5.0e-2);
         get_token_value(from, pos, "etol", etol, 1.0e-2);
         get_token_value(from, pos, "emin", emin, emin_def);
-        get_token_value(from, pos, "emax", emax, 0.0);
+        get_token_value(from, pos, "emax", emax, emax_def);
         get_token_value(from, pos, "rmin", rmin, 0.5);
         get_token_value(from, pos, "temp", temp, 298.15);
         get_token_value(from, pos, "maxiter", maxiter, 500u);
@@ -118,8 +121,8 @@ void Chem::Mcmm<Pot>::solve(std::ostream& to)
         to << "Local minima:\n" << line('-') << '\n';
         for (std::size_t i = 0; i < conformers.size(); ++i) {
             to << "Conformer: " << i + 1 << '\n'
-               << "Energy: " << dfix(conformers[i].energy) << '\n';
-            Chem::print_geometry(to, mol.atoms(), conformers[i].xyz);
+               << "Energy: " << dfix(conformers.energy(i)) << '\n';
+            Chem::print_geometry(to, mol.atoms(), conformers.get_xyz(i));
             to << '\n';
         }
     }
@@ -188,15 +191,8 @@ bool Chem::Mcmm<Pot>::accept_geom_dist(const Chem::Molecule& m) const
 template <class Pot>
 bool Chem::Mcmm<Pot>::duplicate(const Chem::Molecule& m) const
 {
-    bool res = false;
-    for (std::size_t i = 0; i < conformers.size(); ++i) { // check geometry
-        res = Numlib::kabsch_rmsd(conformers[i].xyz, m.get_xyz()) <= xtol;
-        if (res) { // duplicate geometry; check energy
-            double ediff = std::abs(conformers[i].energy - m.elec().energy());
-            res = ediff <= etol;
-        }
-    }
-    return res;
+    // Duplicate if both geometry and energy match a stored conformer:
+    return conformers.contains(m.get_xyz(), xtol, m.elec().energy(), etol);
 }
 
 template <class Pot>
@@ -258,43 +254,29 @@ void Chem::Mcmm<Pot>::uniform_usage(Numlib::Mat<double>& xnew)
 {
     xnew = xcurr;
     if (!conformers.empty()) {
-        std::vector<Chem::Conformer> index;
+        // Find least used with lowest energy:
+        double emin_ = conformers.energy(0);
+        for (std::size_t i = 1; i < conformers.size(); ++i) {
+            emin_ = std::max(emin_, conformers.energy(i));
+        }
         std::size_t istart = 0;
-        int min_nstart = kiter;
-        // Find least used:
         for (std::size_t i = 0; i < conformers.size(); ++i) {
-            if (conformers[i].iter <= min_nstart) {
-                index.push_back(conformers[i]);
+            if (narrow_cast<unsigned>(conformers.usage(i)) <= kiter &&
+                conformers.energy(i) < emin_) {
+                emin_ = conformers.energy(i);
+                istart = i;
             }
         }
-        if (!conformers.empty()) { // find least used with lowest energy
-            auto res = std::max_element(conformers.begin(), conformers.end());
-            auto it = std::distance(conformers.begin(), res);
-            double emin_ = conformers[it].energy;
-            for (std::size_t i = 0; i < index.size(); ++i) {
-                if (index[i].energy < emin_) {
-                    emin_ = index[i].energy;
-                    istart = i;
-                }
-            }
-        }
-        conformers[istart].iter += 1;
-        xnew = conformers[istart].xyz;
+        conformers.use(istart);
+        conformers.get_xyz(istart, xnew);
     }
 }
 
 template <class Pot>
 inline void Chem::Mcmm<Pot>::sort_conformers()
 {
-    std::sort(conformers.begin(), conformers.end());
-    if (conformers.size() > nminima) {
-        std::vector<Conformer> tmp;
-        for (std::size_t i = 0; i < nminima; ++i) {
-            tmp.push_back(Conformer(conformers[i]));
-        }
-        conformers.resize(nminima);
-        conformers = tmp;
-    }
+    conformers.sort();
+    conformers.truncate(nminima);
 }
 
 template <class Pot>
@@ -318,3 +300,7 @@ Chem::Mcmm<Pot>::select_rand_dihedral(const Chem::Molecule& m)
 
 template class Chem::Mcmm<Chem::Gaussian>;
 template class Chem::Mcmm<Chem::Mopac>;
+template class Chem::Mcmm<Chem::Forcefield>;
+template class Chem::Mcmm<Chem::Cascade<Chem::Forcefield, Chem::Gaussian>>;
+template class Chem::Mcmm<Chem::Cascade<Chem::Forcefield, Chem::Mopac>>;
+template class Chem::Mcmm<Chem::Cascade<Chem::Mopac, Chem::Gaussian>>;
@@ -4,13 +4,16 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <chem/mapped_file.h>
 #include <chem/mopac.h>
 #include <numlib/constants.h>
 #include <stdutils/stdutils.h>
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <stdexcept>
 #include <fstream>
-#include <sstream>
+#include <iostream>
 
 void Chem::Mopac::init(std::istream& from, const std::string& key)
 {
@@ -18,12 +21,23 @@ void Chem::Mopac::init(std::istream& from, const std::string& key)
 
     using namespace Stdutils;
 
+    std::string cache_dir;
+    double cache_tol = 1.0e-4;
+    std::string guess_dir;
+    int guess_max = 50;
+
     auto pos = find_token(from, key);
     if (pos != -1) {
         get_token_value(from, pos, "version", version,
                         std::string("mopac5022mn"));
         get_token_value(from, pos, "jobname", jobname, std::string("mopac"));
         get_token_value(from, pos, "opt_geom", opt_geom, 1);
+        get_token_value(from, pos, "batch_size", batch_size, 1);
+        get_token_value(from, pos, "cache_dir", cache_dir, std::string(""));
+        get_token_value(from, pos, "cache_tol", cache_tol, 1.0e-4);
+        get_token_value(from, pos, "guess_dir", guess_dir, std::string(""));
+        get_token_value(from, pos, "guess_rmsd", guess_rmsd, 0.5);
+        get_token_value(from, pos, "guess_max", guess_max, 50);
         pos = find_token(from, "keywords", pos);
         if (pos != -1) {
             std::string line;
@@ -34,38 +48,120 @@ void Chem::Mopac::init(std::istream& from, const std::string& key)
             keywords = trim(line, " ");
         }
     }
+
+    Assert::dynamic(batch_size >= 1, "bad batch_size value");
+
+    cache.reset();
+    if (!cache_dir.empty()) {
+        cache = std::make_shared<Chem::Qm_cache>(cache_dir, cache_tol);
+    }
+    Assert::dynamic(guess_rmsd > 0.0, "bad guess_rmsd value");
+    Assert::dynamic(guess_max > 0, "bad guess_max value");
+    guess.reset();
+    if (!guess_dir.empty()) {
+        guess = std::make_shared<Chem::Guess_store>(guess_dir, ".den",
+                                                    guess_max);
+    }
 }
 
 void Chem::Mopac::run(Chem::Molecule& mol) const
 {
-    write_dat(mol); // create Mopac input file
-
-    bool ok = true;
-    std::string cmd = version + " " + jobname + ".dat";
-    if (std::system(cmd.c_str()) != 0) {
-        ok = false; // running Mopac failed
+    std::string cache_key;
+    if (cache) {
+        cache_key = cache->key(
+            "Mopac|" + keywords + "|" + std::to_string(opt_geom), mol);
+        if (cache->lookup(cache_key, mol)) {
+            return; // result is already computed
+        }
     }
 
-    if (!check_convergence()) {
-        ok = false; // optimization failed
+    bool oldens = false;
+    if (guess) { // use density of closest stored structure
+        oldens = guess->fetch(mol, guess_rmsd, jobname + ".den");
     }
-    if (ok) {
-        Numlib::Mat<double> xyz = mol.get_xyz();
-        get_xyz(xyz);
-        mol.set_xyz(xyz); // update Cartesian coordinates
-        mol.elec().set_energy(get_heat_of_formation()); // update energy
+    write_dat(mol, jobname, oldens); // create Mopac input file
+
+    std::remove((jobname + ".out").c_str()); // do not read old output
+    std::string cmd = version + " " + jobname + ".dat";
+    bool ok = (std::system(cmd.c_str()) == 0);
+
+    update(mol, jobname, cache_key, ok);
+}
+
+void Chem::Mopac::run_batch(std::vector<Chem::Molecule>& mols) const
+{
+    // Job names and cache keys of molecules not found in the cache:
+    std::vector<std::size_t> todo;
+    std::vector<std::string> names;
+    std::vector<std::string> cache_keys;
+    for (std::size_t i = 0; i < mols.size(); ++i) {
+        std::string cache_key;
+        if (cache) {
+            cache_key = cache->key(
+                "Mopac|" + keywords + "|" + std::to_string(opt_geom), mols[i]);
+            if (cache->lookup(cache_key, mols[i])) {
+                continue; // result is already computed
+            }
+        }
+        todo.push_back(i);
+        names.push_back(jobname + "_" + std::to_string(names.size() + 1));
+        cache_keys.push_back(cache_key);
     }
-    else { // calculation failed to converge; set energy to zero
-        constexpr double emax = 0.0;
-        mol.elec().set_energy(emax);
+
+    // Run jobs with one Mopac process per batch_size input files:
+    const auto nbatch = static_cast<std::size_t>(batch_size);
+    for (std::size_t first = 0; first < todo.size(); first += nbatch) {
+        std::size_t last = std::min(first + nbatch, todo.size());
+        std::string cmd = version;
+        for (std::size_t k = first; k < last; ++k) {
+            bool oldens = false;
+            if (guess) {
+                oldens =
+                    guess->fetch(mols[todo[k]], guess_rmsd, names[k] + ".den");
+            }
+            write_dat(mols[todo[k]], names[k], oldens);
+            std::remove((names[k] + ".out").c_str());
+            cmd += " " + names[k] + ".dat";
+        }
+        const int status = std::system(cmd.c_str());
+        bool ok = (status == 0);
+        if (last - first > 1) {
+            // Jobs in a batch fail independently, so output files are read
+            // where they exist; report failures, since a Mopac version
+            // accepting only one input file leaves the rest unrun:
+            std::size_t nmissing = 0;
+            for (std::size_t k = first; k < last; ++k) {
+                if (!std::ifstream(names[k] + ".out")) {
+                    ++nmissing;
+                }
+            }
+            if (status != 0 || nmissing > 0) {
+                std::cerr << "warning: Mopac returned " << status
+                          << " for batch; " << nmissing << " of "
+                          << last - first << " output files are missing\n";
+            }
+            ok = true;
+        }
+        for (std::size_t k = first; k < last; ++k) {
+            update(mols[todo[k]], names[k], cache_keys[k], ok);
+        }
     }
 }
 
-void Chem::Mopac::write_dat(const Chem::Molecule& mol) const
+void Chem::Mopac::write_dat(const Chem::Molecule& mol,
+                            const std::string& name,
+                            bool oldens) const
 {
     std::ofstream to;
-    Stdutils::fopen(to, jobname + ".dat");
-    to << keywords << '\n' << mol.title() << "\n\n";
+    Stdutils::fopen(to, name + ".dat");
+    to << keywords;
+    if (guess) {
+        to << " DENOUT"; // save density for guess store
+    }
+    if (oldens) {
+        to << " OLDENS";
+    }
+    to << '\n' << mol.title() << "\n\n";
     write_xyz(to, mol);
 }
 
@@ -85,106 +181,107 @@ void Chem::Mopac::write_xyz(std::ostream& to, const Chem::Molecule& mol) const
 
 bool Chem::Mopac::check_convergence() const
 {
-    bool converged = false;
+    Numlib::Mat<double> xyz(0, 3);
+    return read_out(jobname, xyz).converged;
+}
 
-    std::ifstream from;
-    Stdutils::fopen(from, jobname + ".out");
+double Chem::Mopac::get_heat_of_formation() const
+{
+    Numlib::Mat<double> xyz(0, 3);
+    auto res = read_out(jobname, xyz);
+    if (!res.heat_found) {
+        throw std::runtime_error("final heat of formation not found");
+    }
+    return res.heat;
+}
 
-    std::string buf;
-    while (std::getline(from, buf)) {
-        std::string pattern = "SCF FIELD WAS ACHIEVED";
-        if (buf.find(pattern) != std::string::npos) {
-            converged = true;
-            break;
-        }
+void Chem::Mopac::get_xyz(Numlib::Mat<double>& xyz) const
+{
+    // Note: xyz must have the correct size on input, no resizing is done.
+
+    if (!read_out(jobname, xyz).xyz_found) {
+        throw std::runtime_error("optimized Cartesian coordinates not found");
     }
-    return converged;
 }
 
-double Chem::Mopac::get_heat_of_formation() const
+//------------------------------------------------------------------------------
+
+void Chem::Mopac::update(Chem::Molecule& mol,
+                         const std::string& name,
+                         const std::string& cache_key,
+                         bool ok) const
 {
-    double heat = 0.0;
-    bool found = false;
-
-    std::ifstream from;
-    Stdutils::fopen(from, jobname + ".out");
-
-    std::string buf;
-    while (std::getline(from, buf)) {
-        std::string pattern = "SCF FIELD WAS ACHIEVED"; // is this fail-safe?
-        if (buf.find(pattern) != std::string::npos) {
-            while (std::getline(from, buf)) {
-                pattern = "FINAL HEAT OF FORMATION = ";
-                if (buf.find(pattern) != std::string::npos) {
-                    std::istringstream iss(buf);
-                    for (int i = 0; i < 5; ++i) { // ignore words in pattern
-                        iss >> buf;
-                    }
-                    iss >> heat;
-                    found = true;
-                    break;
-                }
-            }
+    Numlib::Mat<double> xyz = mol.get_xyz();
+    Out_data res;
+    if (ok) {
+        res = read_out(name, xyz);
+    }
+    if (res.converged && res.heat_found && res.xyz_found) {
+        mol.set_xyz(xyz);                 // update Cartesian coordinates
+        mol.elec().set_energy(res.heat); // update energy
+        if (cache) {
+            cache->store(cache_key, mol);
         }
-        if (found) {
-            break;
+        if (guess) {
+            guess->store(mol, name + ".den");
         }
     }
-    if (!found) {
-        throw std::runtime_error("final heat of formation not found");
-    }
-    else {
-        return heat * Numlib::Constants::cal_to_J;
+    else { // calculation failed to converge; set energy to zero
+        constexpr double emax = 0.0;
+        mol.elec().set_energy(emax);
     }
 }
 
-void Chem::Mopac::get_xyz(Numlib::Mat<double>& xyz) const
+Chem::Mopac::Out_data Chem::Mopac::read_out(const std::string& name,
+                                            Numlib::Mat<double>& xyz) const
 {
-    // Note: xyz must have the correct size on input, no resizing is done.
+    // Results are read after the SCF convergence message in one pass.
 
-    bool found = false;
-
-    std::ifstream from;
-    Stdutils::fopen(from, jobname + ".out");
-
-    std::string buf;
-    while (std::getline(from, buf)) {
-        std::string pattern = "SCF FIELD WAS ACHIEVED"; // is this fail-safe?
-        if (buf.find(pattern) != std::string::npos) {
-            while (std::getline(from, buf)) {
-                pattern = "CARTESIAN COORDINATES";
-                if (buf.find(pattern) != std::string::npos) {
-                    int nlines = 3;
-                    if (version == "mopac2016") {
-                        nlines = 1;
-                    }
-                    for (int i = 0; i < nlines; ++i) { // ignore lines
-                        std::getline(from, buf);
-                    }
-                    int center;
-                    std::string atom;
-                    double x;
-                    double y;
-                    double z;
-                    for (Index i = 0; i < xyz.rows(); ++i) {
-                        std::getline(from, buf);
-                        std::istringstream iss(buf);
-                        iss >> center >> atom >> x >> y >> z;
-                        xyz(i, 0) = x;
-                        xyz(i, 1) = y;
-                        xyz(i, 2) = z;
-                    }
-                    found = true;
-                    break;
+    Out_data res;
+
+    Mapped_file file;
+    if (!file.open(name + ".out")) {
+        return res; // Mopac failed to run
+    }
+
+    Line_reader from(file.view());
+    Text_view line;
+    while (from.next(line)) {
+        if (!res.converged) {
+            if (line.contains("SCF FIELD WAS ACHIEVED")) {
+                res.converged = true;
+            }
+        }
+        else if (!res.heat_found &&
+                 line.contains("FINAL HEAT OF FORMATION = ")) {
+            // Value follows the five words in pattern:
+            if (parse_double(get_token(line, 5), res.heat)) {
+                res.heat *= Numlib::Constants::cal_to_J;
+                res.heat_found = true;
+            }
+        }
+        else if (!res.xyz_found && line.contains("CARTESIAN COORDINATES")) {
+            int nlines = 3;
+            if (version == "mopac2016") {
+                nlines = 1;
+            }
+            for (int i = 0; i < nlines; ++i) { // ignore lines
+                from.next(line);
+            }
+            for (Index i = 0; i < xyz.rows(); ++i) {
+                from.next(line);
+                const char* p = line.begin();
+                next_token(p, line.end()); // center
+                next_token(p, line.end()); // atom
+                for (Index j = 0; j < 3; ++j) {
+                    parse_double(p, line.end(), xyz(i, j));
                 }
             }
+            res.xyz_found = true;
         }
-        if (found) {
+        if (res.heat_found && res.xyz_found) {
             break;
         }
     }
-    if (!found) {
-        throw std::runtime_error("optimized Cartesian coordinates not found");
-    }
+    return res;
 }
-
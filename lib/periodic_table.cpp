@@ -6,16 +6,18 @@
 
 #include <chem/periodic_table.h>
 #include <stdutils/stdutils.h>
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstring>
 
 namespace Chem {
 
 namespace Periodic_table {
 
-    const int num_elements = 119;
+    constexpr int num_elements = 119;
 
-    const std::array<std::string, num_elements> elements = {
+    constexpr std::array<const char*, num_elements> elements = {
         "X",  "H",  "He", "Li", "Be", "B",  "C",  "N",  "O",  "F",  "Ne", "Na",
         "Mg", "Al", "Si", "P",  "S",  "Cl", "Ar", "K",  "Ca", "Sc", "Ti", "V",
         "Cr", "Mn", "Fe", "Co", "Ni", "Cu", "Zn", "Ga", "Ge", "As", "Se", "Br",
@@ -27,9 +29,9 @@ namespace Periodic_table {
         "Cm", "Bk", "Cf", "Es", "Fm", "Md", "No", "Lr", "Rf", "Db", "Sg", "Bh",
         "Hs", "Mt", "Ds", "Rg", "Cn", "Nh", "Fl", "Mc", "Lv", "Ts", "Og"};
 
-    constexpr int num_isotopes = 3352;
+    constexpr int num_isotopes = 3357;
 
-    const std::array<std::string, num_isotopes> isotopes = {
+    constexpr std::array<const char*, num_isotopes> isotopes = {
         "X",     "H",     "D",     "T",     "4H",    "5H",    "6H",    "7H",
         "3He",   "He",    "5He",   "6He",   "7He",   "8He",   "9He",   "10He",
         "3Li",   "4Li",   "5Li",   "6Li",   "Li",    "8Li",   "9Li",   "10Li",
@@ -432,25 +434,26 @@ namespace Periodic_table {
         "255Rf", "256Rf", "257Rf", "258Rf", "259Rf", "260Rf", "261Rf", "262Rf",
         "263Rf", "264Rf", "265Rf", "266Rf", "267Rf", "268Rf", "Db",    "256Db",
         "257Db", "258Db", "259Db", "260Db", "261Db", "262Db", "263Db", "264Db",
-        "265Db", "266Db", "267Db", "268Db", "269Db", "270Db", "258Sg", "259Sg",
-        "260Sg", "261Sg", "262Sg", "263Sg", "264Sg", "265Sg", "266Sg", "267Sg",
-        "268Sg", "269Sg", "270Sg", "271Sg", "272Sg", "273Sg", "260Bh", "261Bh",
-        "262Bh", "263Bh", "264Bh", "265Bh", "266Bh", "267Bh", "268Bh", "269Bh",
-        "270Bh", "271Bh", "272Bh", "273Bh", "274Bh", "275Bh", "263Hs", "264Hs",
-        "265Hs", "266Hs", "267Hs", "268Hs", "269Hs", "270Hs", "271Hs", "272Hs",
-        "273Hs", "274Hs", "275Hs", "276Hs", "277Hs", "265Mt", "266Mt", "267Mt",
-        "268Mt", "269Mt", "270Mt", "271Mt", "272Mt", "273Mt", "274Mt", "275Mt",
-        "276Mt", "277Mt", "278Mt", "279Mt", "267Ds", "268Ds", "269Ds", "270Ds",
-        "271Ds", "272Ds", "273Ds", "274Ds", "275Ds", "276Ds", "277Ds", "278Ds",
-        "279Ds", "280Ds", "281Ds", "Rg",    "273Rg", "274Rg", "275Rg", "276Rg",
-        "277Rg", "278Rg", "279Rg", "280Rg", "281Rg", "282Rg", "283Rg", "Cn",
-        "277Cn", "278Cn", "279Cn", "280Cn", "281Cn", "282Cn", "283Cn", "284Cn",
-        "285Cn", "Nh",    "279Nh", "280Nh", "281Nh", "282Nh", "283Nh", "284Nh",
-        "285Nh", "286Nh", "287Nh", "Fl",    "286Fl", "287Fl", "288Fl", "289Fl",
-        "Mc",    "288Mc", "289Mc", "290Mc", "291Mc", "Lv",    "290Lv", "291Lv",
-        "292Lv", "293Lv", "Ts",    "292Ts", "293Ts", "294Ts", "Og",    "294Og"};
+        "265Db", "266Db", "267Db", "268Db", "269Db", "270Db", "Sg",    "258Sg",
+        "259Sg", "260Sg", "261Sg", "262Sg", "263Sg", "264Sg", "265Sg", "266Sg",
+        "267Sg", "268Sg", "269Sg", "270Sg", "271Sg", "272Sg", "273Sg", "Bh",
+        "260Bh", "261Bh", "262Bh", "263Bh", "264Bh", "265Bh", "266Bh", "267Bh",
+        "268Bh", "269Bh", "270Bh", "271Bh", "272Bh", "273Bh", "274Bh", "275Bh",
+        "Hs",    "263Hs", "264Hs", "265Hs", "266Hs", "267Hs", "268Hs", "269Hs",
+        "270Hs", "271Hs", "272Hs", "273Hs", "274Hs", "275Hs", "276Hs", "277Hs",
+        "Mt",    "265Mt", "266Mt", "267Mt", "268Mt", "269Mt", "270Mt", "271Mt",
+        "272Mt", "273Mt", "274Mt", "275Mt", "276Mt", "277Mt", "278Mt", "279Mt",
+        "Ds",    "267Ds", "268Ds", "269Ds", "270Ds", "271Ds", "272Ds", "273Ds",
+        "274Ds", "275Ds", "276Ds", "277Ds", "278Ds", "279Ds", "280Ds", "281Ds",
+        "Rg",    "273Rg", "274Rg", "275Rg", "276Rg", "277Rg", "278Rg", "279Rg",
+        "280Rg", "281Rg", "282Rg", "283Rg", "Cn",    "277Cn", "278Cn", "279Cn",
+        "280Cn", "281Cn", "282Cn", "283Cn", "284Cn", "285Cn", "Nh",    "279Nh",
+        "280Nh", "281Nh", "282Nh", "283Nh", "284Nh", "285Nh", "286Nh", "287Nh",
+        "Fl",    "286Fl", "287Fl", "288Fl", "289Fl", "Mc",    "288Mc", "289Mc",
+        "290Mc", "291Mc", "Lv",    "290Lv", "291Lv", "292Lv", "293Lv", "Ts",
+        "292Ts", "293Ts", "294Ts", "Og",    "294Og"};
 
-    const std::array<int, num_isotopes> mass_numbers = {
+    constexpr std::array<int, num_isotopes> mass_numbers = {
         0,   1,   2,   3,   4,   5,   6,   7,   3,   4,   5,   6,   7,   8,
         9,   10,  3,   4,   5,   6,   7,   8,   9,   10,  11,  12,  13,  5,
         6,   7,   8,   9,   10,  11,  12,  13,  14,  15,  16,  6,   7,   8,
@@ -681,18 +684,18 @@ namespace Periodic_table {
         255, 256, 257, 258, 259, 260, 261, 262, 263, 264, 265, 266, 253, 254,
         255, 256, 257, 258, 259, 260, 261, 262, 263, 264, 265, 266, 267, 268,
         255, 256, 257, 258, 259, 260, 261, 262, 263, 264, 265, 266, 267, 268,
-        269, 270, 258, 259, 260, 261, 262, 263, 264, 265, 266, 267, 268, 269,
-        270, 271, 272, 273, 260, 261, 262, 263, 264, 265, 266, 267, 268, 269,
-        270, 271, 272, 273, 274, 275, 263, 264, 265, 266, 267, 268, 269, 270,
-        271, 272, 273, 274, 275, 276, 277, 265, 266, 267, 268, 269, 270, 271,
-        272, 273, 274, 275, 276, 277, 278, 279, 267, 268, 269, 270, 271, 272,
-        273, 274, 275, 276, 277, 278, 279, 280, 281, 272, 273, 274, 275, 276,
-        277, 278, 279, 280, 281, 282, 283, 276, 277, 278, 279, 280, 281, 282,
-        283, 284, 285, 278, 279, 280, 281, 282, 283, 284, 285, 286, 287, 285,
-        286, 287, 288, 289, 287, 288, 289, 290, 291, 289, 290, 291, 292, 293,
-        291, 292, 293, 294, 293, 294};
+        269, 270, 258, 258, 259, 260, 261, 262, 263, 264, 265, 266, 267, 268,
+        269, 270, 271, 272, 273, 260, 260, 261, 262, 263, 264, 265, 266, 267,
+        268, 269, 270, 271, 272, 273, 274, 275, 263, 263, 264, 265, 266, 267,
+        268, 269, 270, 271, 272, 273, 274, 275, 276, 277, 265, 265, 266, 267,
+        268, 269, 270, 271, 272, 273, 274, 275, 276, 277, 278, 279, 267, 267,
+        268, 269, 270, 271, 272, 273, 274, 275, 276, 277, 278, 279, 280, 281,
+        272, 273, 274, 275, 276, 277, 278, 279, 280, 281, 282, 283, 276, 277,
+        278, 279, 280, 281, 282, 283, 284, 285, 278, 279, 280, 281, 282, 283,
+        284, 285, 286, 287, 285, 286, 287, 288, 289, 287, 288, 289, 290, 291,
+        289, 290, 291, 292, 293, 291, 292, 293, 294, 293, 294};
 
-    const std::array<double, num_isotopes> atomic_masses = {
+    constexpr std::array<double, num_isotopes> atomic_masses = {
         0.000000,   1.007825,   2.014102,   3.016049,   4.026430,   5.035311,
         6.044960,   7.052700,   3.016029,   4.002603,   5.012057,   6.018886,
         7.027991,   8.033934,   9.043946,   10.052790,  3.030800,   4.027190,
@@ -1230,30 +1233,31 @@ namespace Periodic_table {
         267.121790, 268.123970, 255.107070, 256.107890, 257.107580, 258.109280,
         259.109492, 260.111300, 261.111920, 262.114070, 263.114990, 264.117410,
         265.118610, 266.121030, 267.122470, 268.125670, 269.127910, 270.131360,
-        258.112980, 259.114400, 260.114384, 261.115949, 262.116337, 263.118290,
-        264.118930, 265.121090, 266.121980, 267.124360, 268.125390, 269.128630,
-        270.130430, 271.133930, 272.135890, 273.139580, 260.121660, 261.121450,
-        262.122970, 263.122920, 264.124590, 265.124910, 266.126790, 267.127500,
-        268.129690, 269.130420, 270.133360, 271.135260, 272.138260, 273.140240,
-        274.143550, 275.145670, 263.128520, 264.128357, 265.129793, 266.130046,
-        267.131670, 268.131860, 269.133750, 270.134290, 271.137170, 272.138500,
-        273.141680, 274.143300, 275.146670, 276.148460, 277.151900, 265.136000,
-        266.137370, 267.137190, 268.138650, 269.138820, 270.140330, 271.140740,
-        272.143410, 273.144400, 274.147240, 275.148820, 276.151590, 277.153270,
-        278.156310, 279.158080, 267.143770, 268.143480, 269.144752, 270.144584,
-        271.145950, 272.146020, 273.148560, 274.149410, 275.152030, 276.153030,
-        277.155910, 278.157040, 279.160100, 280.161310, 281.164510, 272.153270,
-        273.153130, 274.155250, 275.155940, 276.158330, 277.159070, 278.161490,
-        279.162720, 280.165140, 281.166360, 282.169120, 283.170540, 276.161410,
-        277.163640, 278.164160, 279.166540, 280.167150, 281.169750, 282.170500,
-        283.173270, 284.174160, 285.177120, 278.170580, 279.170950, 280.172930,
-        281.173480, 282.175670, 283.176570, 284.178730, 285.179730, 286.182210,
-        287.183390, 285.183640, 286.184230, 287.186780, 288.187570, 289.190420,
-        287.190700, 288.192740, 289.193630, 290.195980, 291.197070, 289.198160,
-        290.198640, 291.201080, 292.201740, 293.204490, 291.205530, 292.207460,
-        293.208240, 294.210460, 293.213560, 294.213920};
+        258.112980, 258.112980, 259.114400, 260.114384, 261.115949, 262.116337,
+        263.118290, 264.118930, 265.121090, 266.121980, 267.124360, 268.125390,
+        269.128630, 270.130430, 271.133930, 272.135890, 273.139580, 260.121660,
+        260.121660, 261.121450, 262.122970, 263.122920, 264.124590, 265.124910,
+        266.126790, 267.127500, 268.129690, 269.130420, 270.133360, 271.135260,
+        272.138260, 273.140240, 274.143550, 275.145670, 263.128520, 263.128520,
+        264.128357, 265.129793, 266.130046, 267.131670, 268.131860, 269.133750,
+        270.134290, 271.137170, 272.138500, 273.141680, 274.143300, 275.146670,
+        276.148460, 277.151900, 265.136000, 265.136000, 266.137370, 267.137190,
+        268.138650, 269.138820, 270.140330, 271.140740, 272.143410, 273.144400,
+        274.147240, 275.148820, 276.151590, 277.153270, 278.156310, 279.158080,
+        267.143770, 267.143770, 268.143480, 269.144752, 270.144584, 271.145950,
+        272.146020, 273.148560, 274.149410, 275.152030, 276.153030, 277.155910,
+        278.157040, 279.160100, 280.161310, 281.164510, 272.153270, 273.153130,
+        274.155250, 275.155940, 276.158330, 277.159070, 278.161490, 279.162720,
+        280.165140, 281.166360, 282.169120, 283.170540, 276.161410, 277.163640,
+        278.164160, 279.166540, 280.167150, 281.169750, 282.170500, 283.173270,
+        284.174160, 285.177120, 278.170580, 279.170950, 280.172930, 281.173480,
+        282.175670, 283.176570, 284.178730, 285.179730, 286.182210, 287.183390,
+        285.183640, 286.184230, 287.186780, 288.187570, 289.190420, 287.190700,
+        288.192740, 289.193630, 290.195980, 291.197070, 289.198160, 290.198640,
+        291.201080, 292.201740, 293.204490, 291.205530, 292.207460, 293.208240,
+        294.210460, 293.213560, 294.213920};
 
-    const std::array<double, num_isotopes> atomic_weights = {
+    constexpr std::array<double, num_isotopes> atomic_weights = {
         0.000000,   1.007975,   1.007975,   1.007975,   1.007975,   1.007975,
         1.007975,   1.007975,   4.002602,   4.002602,   4.002602,   4.002602,
         4.002602,   4.002602,   4.002602,   4.002602,   6.967500,   6.967500,
@@ -1812,9 +1816,10 @@ namespace Periodic_table {
         0.000000,   0.000000,   0.000000,   0.000000,   0.000000,   0.000000,
         0.000000,   0.000000,   0.000000,   0.000000,   0.000000,   0.000000,
         0.000000,   0.000000,   0.000000,   0.000000,   0.000000,   0.000000,
-        0.000000,   0.000000,   0.000000,   0.000000};
+        0.000000,   0.000000,   0.000000,   0.000000,   0.000000,   0.000000,
+        0.000000,   0.000000,   0.000000};
 
-    const std::array<double, num_isotopes> isotope_comp = {
+    constexpr std::array<double, num_isotopes> isotope_comp = {
         0.000000, 0.999885, 0.000115, 0.000000, 0.000000, 0.000000, 0.000000,
         0.000000, 0.000001, 0.999999, 0.000000, 0.000000, 0.000000, 0.000000,
         0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.075900, 0.924100,
@@ -2293,9 +2298,10 @@ namespace Periodic_table {
         0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
         0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
         0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
-        0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000};
+        0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+        0.000000, 0.000000, 0.000000, 0.000000};
 
-    const std::array<int, num_isotopes> atomic_numbers = {
+    constexpr std::array<int, num_isotopes> atomic_numbers = {
         0,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,
         2,   2,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   4,
         4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   5,   5,   5,
@@ -2527,37 +2533,57 @@ namespace Periodic_table {
         104, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104,
         105, 105, 105, 105, 105, 105, 105, 105, 105, 105, 105, 105, 105, 105,
         105, 105, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106,
-        106, 106, 106, 106, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107,
-        107, 107, 107, 107, 107, 107, 108, 108, 108, 108, 108, 108, 108, 108,
-        108, 108, 108, 108, 108, 108, 108, 109, 109, 109, 109, 109, 109, 109,
-        109, 109, 109, 109, 109, 109, 109, 109, 110, 110, 110, 110, 110, 110,
-        110, 110, 110, 110, 110, 110, 110, 110, 110, 111, 111, 111, 111, 111,
-        111, 111, 111, 111, 111, 111, 111, 112, 112, 112, 112, 112, 112, 112,
-        112, 112, 112, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 114,
-        114, 114, 114, 114, 115, 115, 115, 115, 115, 116, 116, 116, 116, 116,
-        117, 117, 117, 117, 118, 118};
+        106, 106, 106, 106, 106, 107, 107, 107, 107, 107, 107, 107, 107, 107,
+        107, 107, 107, 107, 107, 107, 107, 107, 108, 108, 108, 108, 108, 108,
+        108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 109, 109, 109, 109,
+        109, 109, 109, 109, 109, 109, 109, 109, 109, 109, 109, 109, 110, 110,
+        110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+        111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 112, 112,
+        112, 112, 112, 112, 112, 112, 112, 112, 113, 113, 113, 113, 113, 113,
+        113, 113, 113, 113, 114, 114, 114, 114, 114, 115, 115, 115, 115, 115,
+        116, 116, 116, 116, 116, 117, 117, 117, 117, 118, 118};
 
-    Element get_element(const std::string& symbol)
+    // Get isotopes sorted by symbol, built on first use.
+    const std::array<short, num_isotopes>& sorted_isotopes()
     {
-        int idx = -1;
-        for (int i = 0; i < num_isotopes; ++i) {
-            if (symbol == isotopes[i]) {
-                idx = i;
+        static const std::array<short, num_isotopes> sorted = []() {
+            std::array<short, num_isotopes> idx;
+            for (int i = 0; i < num_isotopes; ++i) {
+                idx[i] = static_cast<short>(i);
             }
+            std::sort(idx.begin(), idx.end(), [](short a, short b) {
+                return std::strcmp(isotopes[a], isotopes[b]) < 0;
+            });
+            return idx;
+        }();
+        return sorted;
+    }
+
+    Element_ref find_element(const std::string& symbol)
+    {
+        const auto& sorted = sorted_isotopes();
+        auto it = std::lower_bound(
+            sorted.begin(), sorted.end(), symbol, [](short a, const auto& s) {
+                return std::strcmp(isotopes[a], s.c_str()) < 0;
+            });
+        if (it != sorted.end() && symbol == isotopes[*it]) {
+            return Element_ref(*it);
         }
-        Element elem;
-        if (idx == -1) {
+        return Element_ref();
+    }
+
+    Element_ref get_element_ref(const std::string& symbol)
+    {
+        Element_ref ref = find_element(symbol);
+        if (!ref.valid()) {
             throw Bad_atomic_symbol(symbol + " is not a valid atom");
         }
-        else {
-            elem.atomic_symbol = isotopes[idx];
-            elem.atomic_number = atomic_numbers[idx];
-            elem.mass_number = mass_numbers[idx];
-            elem.atomic_mass = atomic_masses[idx];
-            elem.atomic_weight = atomic_weights[idx];
-            elem.isotope_comp = isotope_comp[idx];
-        }
-        return elem;
+        return ref;
+    }
+
+    Element get_element(const std::string& symbol)
+    {
+        return get_element_ref(symbol).element();
     }
 
     std::string get_atomic_symbol(int atomic_number)
@@ -2568,14 +2594,55 @@ namespace Periodic_table {
 
     bool atomic_symbol_is_valid(const std::string& symbol)
     {
-        bool valid = false;
-        for (int i = 0; i < num_isotopes; ++i) {
-            if (Stdutils::trim(symbol, " ") == isotopes[i]) {
-                valid = true;
-                break;
-            }
-        }
-        return valid;
+        return find_element(Stdutils::trim(symbol, " ")).valid();
+    }
+
+    const char* Element_ref::atomic_symbol() const
+    {
+        assert(valid());
+        return isotopes[idx];
+    }
+
+    int Element_ref::atomic_number() const
+    {
+        assert(valid());
+        return atomic_numbers[idx];
+    }
+
+    int Element_ref::mass_number() const
+    {
+        assert(valid());
+        return mass_numbers[idx];
+    }
+
+    double Element_ref::atomic_mass() const
+    {
+        assert(valid());
+        return atomic_masses[idx];
+    }
+
+    double Element_ref::atomic_weight() const
+    {
+        assert(valid());
+        return atomic_weights[idx];
+    }
+
+    double Element_ref::isotope_comp() const
+    {
+        assert(valid());
+        return Periodic_table::isotope_comp[idx];
+    }
+
+    Element Element_ref::element() const
+    {
+        Element elem;
+        elem.atomic_symbol = atomic_symbol();
+        elem.atomic_number = atomic_number();
+        elem.mass_number = mass_number();
+        elem.atomic_mass = atomic_mass();
+        elem.atomic_weight = atomic_weight();
+        elem.isotope_comp = isotope_comp();
+        return elem;
     }
 
 } // namespace Periodic_table
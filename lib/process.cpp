@@ -0,0 +1,113 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/process.h>
+#include <stdutils/stdutils.h>
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+Chem::Process::~Process()
+{
+    if (!done) {
+        wait();
+    }
+}
+
+#ifndef _WIN32
+
+void Chem::Process::start(const std::string& cmd)
+{
+    Assert::dynamic(done, "process is already running");
+
+    pid_t child = fork();
+    if (child == -1) {
+        throw std::runtime_error("could not start process: " + cmd);
+    }
+    if (child == 0) {
+        // Put the child in its own process group, so that the whole job
+        // can be killed:
+        setpgid(0, 0);
+        execl("/bin/sh", "sh", "-c", cmd.c_str(), static_cast<char*>(nullptr));
+        _exit(127); // exec failed
+    }
+    setpgid(child, child); // avoid race with the child
+    pid = child;
+    status = 0;
+    done = false;
+}
+
+bool Chem::Process::running()
+{
+    if (done) {
+        return false;
+    }
+    int wstatus;
+    pid_t res = waitpid(static_cast<pid_t>(pid), &wstatus, WNOHANG);
+    if (res == 0) {
+        return true;
+    }
+    if (res == static_cast<pid_t>(pid)) {
+        status = WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : -1;
+    }
+    else {
+        status = -1;
+    }
+    done = true;
+    return false;
+}
+
+int Chem::Process::wait()
+{
+    if (!done) {
+        int wstatus;
+        pid_t res;
+        do {
+            res = waitpid(static_cast<pid_t>(pid), &wstatus, 0);
+        } while (res == -1 && errno == EINTR);
+        if (res == static_cast<pid_t>(pid) && WIFEXITED(wstatus)) {
+            status = WEXITSTATUS(wstatus);
+        }
+        else {
+            status = -1;
+        }
+        done = true;
+    }
+    return status;
+}
+
+void Chem::Process::kill()
+{
+    if (!done) {
+        ::kill(-static_cast<pid_t>(pid), SIGKILL);
+        wait();
+        status = -1;
+    }
+}
+
+#else
+
+void Chem::Process::start(const std::string& cmd)
+{
+    // No asynchronous process management; run command to completion:
+    status = std::system(cmd.c_str());
+    done = true;
+}
+
+bool Chem::Process::running() { return false; }
+
+int Chem::Process::wait() { return status; }
+
+void Chem::Process::kill() {}
+
+#endif
@@ -0,0 +1,162 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/qm_cache.h>
+#include <stdutils/stdutils.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+Chem::Qm_cache::Qm_cache(const std::string& dir, double tol)
+    : cache_dir(dir), xtol(tol), ntmp(0)
+{
+    Assert::dynamic(!cache_dir.empty(), "bad cache directory");
+    Assert::dynamic(xtol > 0.0, "bad cache tolerance <= 0.0");
+
+    // Create cache directory if it does not exist:
+#ifdef _WIN32
+    _mkdir(cache_dir.c_str());
+#else
+    mkdir(cache_dir.c_str(), 0755);
+#endif
+
+    // Temporary file names must be unique across processes sharing the
+    // cache directory:
+    std::random_device rd;
+    ntmp = (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+}
+
+std::string Chem::Qm_cache::key(const std::string& method,
+                                const Chem::Molecule& mol) const
+{
+    std::ostringstream os;
+
+    // Method keywords on one line:
+    for (auto c : method) {
+        os << ((c == '\n' || c == '\r' || c == '\t') ? ' ' : c);
+    }
+    os << '|' << mol.elec().charge() << ' ' << mol.elec().spin_mult() << '|';
+
+    // Coordinates relative to the centroid, rounded to the tolerance:
+    const auto& xyz = mol.get_xyz();
+    double c[3] = {0.0, 0.0, 0.0};
+    for (Index i = 0; i < xyz.rows(); ++i) {
+        for (Index j = 0; j < 3; ++j) {
+            c[j] += xyz(i, j);
+        }
+    }
+    for (auto& cj : c) {
+        cj /= static_cast<double>(xyz.rows());
+    }
+    for (Index i = 0; i < xyz.rows(); ++i) {
+        os << mol.atoms()[i].atomic_symbol;
+        for (Index j = 0; j < 3; ++j) {
+            long long n = std::llround((xyz(i, j) - c[j]) / xtol);
+            os << ' ' << (n == 0 ? 0 : n); // avoid negative zero
+        }
+        os << ';';
+    }
+    return os.str();
+}
+
+bool Chem::Qm_cache::lookup(const std::string& key, Chem::Molecule& mol)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        Entry entry;
+        if (!read_entry(key, entry)) {
+            return false;
+        }
+        it = entries.emplace(key, std::move(entry)).first;
+    }
+    if (!Numlib::same_extents(it->second.xyz, mol.get_xyz())) {
+        return false;
+    }
+    mol.set_xyz(it->second.xyz);
+    mol.elec().set_energy(it->second.energy);
+    return true;
+}
+
+void Chem::Qm_cache::store(const std::string& key, const Chem::Molecule& mol)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    entries[key] = Entry{mol.elec().energy(), mol.get_xyz()};
+
+    // Write to a temporary file and rename it into place, so that readers
+    // never see a partially written entry:
+    std::string fname = path(key);
+    std::ostringstream tmp;
+    tmp << fname << ".tmp" << std::hex << ntmp++;
+
+    std::ofstream to(tmp.str());
+    if (!to) {
+        return; // caching is best effort
+    }
+    to.precision(17);
+    to << key << '\n' << mol.elec().energy() << '\n' << mol.num_atoms() << '\n';
+    const auto& xyz = mol.get_xyz();
+    for (Index i = 0; i < xyz.rows(); ++i) {
+        to << xyz(i, 0) << ' ' << xyz(i, 1) << ' ' << xyz(i, 2) << '\n';
+    }
+    to.close();
+    if (!to || std::rename(tmp.str().c_str(), fname.c_str()) != 0) {
+        std::remove(tmp.str().c_str());
+    }
+}
+
+//------------------------------------------------------------------------------
+
+std::string Chem::Qm_cache::path(const std::string& key) const
+{
+    std::ostringstream os;
+    os << cache_dir << '/' << std::hex << fnv1a_hash(key) << ".qmc";
+    return os.str();
+}
+
+bool Chem::Qm_cache::read_entry(const std::string& key, Entry& entry) const
+{
+    std::ifstream from(path(key));
+    if (!from) {
+        return false;
+    }
+    std::string line;
+    std::getline(from, line);
+    if (line != key) { // hash collision
+        return false;
+    }
+    Index natoms;
+    from >> entry.energy >> natoms;
+    if (!from || natoms < 0) {
+        return false;
+    }
+    entry.xyz.resize(natoms, 3);
+    for (Index i = 0; i < natoms; ++i) {
+        from >> entry.xyz(i, 0) >> entry.xyz(i, 1) >> entry.xyz(i, 2);
+    }
+    return static_cast<bool>(from);
+}
+
+std::uint64_t Chem::fnv1a_hash(const std::string& str)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (auto c : str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,153 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/rmsd.h>
+#include <cmath>
+
+double Chem::qcp_rmsd(const double* a,
+                      const double* b,
+                      Index natoms,
+                      double rmsd_max)
+{
+    if (natoms < 1) {
+        return 0.0;
+    }
+    const double n = static_cast<double>(natoms);
+
+    // Centroids:
+    double ca[3] = {0.0, 0.0, 0.0};
+    double cb[3] = {0.0, 0.0, 0.0};
+    for (Index i = 0; i < natoms; ++i) {
+        const double* ai = a + 3 * i;
+        const double* bi = b + 3 * i;
+        ca[0] += ai[0];
+        ca[1] += ai[1];
+        ca[2] += ai[2];
+        cb[0] += bi[0];
+        cb[1] += bi[1];
+        cb[2] += bi[2];
+    }
+    for (int k = 0; k < 3; ++k) {
+        ca[k] /= n;
+        cb[k] /= n;
+    }
+
+    // Inner products and correlation matrix of the centered structures:
+    double ga = 0.0;
+    double gb = 0.0;
+    double sxx = 0.0;
+    double sxy = 0.0;
+    double sxz = 0.0;
+    double syx = 0.0;
+    double syy = 0.0;
+    double syz = 0.0;
+    double szx = 0.0;
+    double szy = 0.0;
+    double szz = 0.0;
+    for (Index i = 0; i < natoms; ++i) {
+        const double* ai = a + 3 * i;
+        const double* bi = b + 3 * i;
+        const double x1 = ai[0] - ca[0];
+        const double y1 = ai[1] - ca[1];
+        const double z1 = ai[2] - ca[2];
+        const double x2 = bi[0] - cb[0];
+        const double y2 = bi[1] - cb[1];
+        const double z2 = bi[2] - cb[2];
+        ga += x1 * x1 + y1 * y1 + z1 * z1;
+        gb += x2 * x2 + y2 * y2 + z2 * z2;
+        sxx += x1 * x2;
+        sxy += x1 * y2;
+        sxz += x1 * z2;
+        syx += y1 * x2;
+        syy += y1 * y2;
+        syz += y1 * z2;
+        szx += z1 * x2;
+        szy += z1 * y2;
+        szz += z1 * z2;
+    }
+
+    // The largest eigenvalue is bounded by sqrt(ga * gb), which gives a
+    // lower bound on the RMSD that is available before any iteration:
+    const double lower = std::abs(std::sqrt(ga) - std::sqrt(gb)) / std::sqrt(n);
+    if (lower > rmsd_max) {
+        return lower;
+    }
+
+    // Coefficients of the characteristic polynomial of the key matrix:
+    const double sxx2 = sxx * sxx;
+    const double syy2 = syy * syy;
+    const double szz2 = szz * szz;
+    const double sxy2 = sxy * sxy;
+    const double syz2 = syz * syz;
+    const double sxz2 = sxz * sxz;
+    const double syx2 = syx * syx;
+    const double szy2 = szy * szy;
+    const double szx2 = szx * szx;
+
+    const double syzszymsyyszz2 = 2.0 * (syz * szy - syy * szz);
+    const double sxx2syy2szz2syz2szy2 = syy2 + szz2 - sxx2 + syz2 + szy2;
+
+    const double c2 = -2.0 * (sxx2 + syy2 + szz2 + sxy2 + syx2 + sxz2 + szx2 +
+                              syz2 + szy2);
+    const double c1 = 8.0 * (sxx * syz * szy + syy * szx * sxz +
+                             szz * sxy * syx - sxx * syy * szz -
+                             syz * szx * sxy - szy * syx * sxz);
+
+    const double sxzpszx = sxz + szx;
+    const double syzpszy = syz + szy;
+    const double sxypsyx = sxy + syx;
+    const double syzmszy = syz - szy;
+    const double sxzmszx = sxz - szx;
+    const double sxymsyx = sxy - syx;
+    const double sxxpsyy = sxx + syy;
+    const double sxxmsyy = sxx - syy;
+    const double sxy2sxz2syx2szx2 = sxy2 + sxz2 - syx2 - szx2;
+
+    // clang-format off
+    const double c0 =
+        sxy2sxz2syx2szx2 * sxy2sxz2syx2szx2 +
+        (sxx2syy2szz2syz2szy2 + syzszymsyyszz2) *
+            (sxx2syy2szz2syz2szy2 - syzszymsyyszz2) +
+        (-sxzpszx * syzmszy + sxymsyx * (sxxmsyy - szz)) *
+            (-sxzmszx * syzpszy + sxymsyx * (sxxmsyy + szz)) +
+        (-sxzpszx * syzpszy - sxypsyx * (sxxpsyy - szz)) *
+            (-sxzmszx * syzmszy - sxypsyx * (sxxpsyy + szz)) +
+        (sxypsyx * syzpszy + sxzpszx * (sxxmsyy + szz)) *
+            (-sxymsyx * syzmszy + sxzpszx * (sxxpsyy + szz)) +
+        (sxypsyx * syzmszy + sxzmszx * (sxxmsyy - szz)) *
+            (-sxymsyx * syzpszy + sxzmszx * (sxxpsyy - szz));
+    // clang-format on
+
+    // Find the largest eigenvalue by Newton-Raphson iterations starting
+    // from the upper bound (ga + gb) / 2. The iterates decrease towards the
+    // largest eigenvalue, hence each intermediate RMSD is a lower bound on
+    // the final RMSD and can be used for early exit:
+    const double e0 = 0.5 * (ga + gb);
+    const double evalprec = 1.0e-11;
+    const int maxiter = 50;
+
+    double lambda = e0;
+    double rmsd = 0.0;
+    for (int it = 0; it < maxiter; ++it) {
+        const double lambda_old = lambda;
+        const double x2 = lambda * lambda;
+        const double bb = (x2 + c2) * lambda;
+        const double aa = bb + c1;
+        const double denom = 2.0 * x2 * lambda + bb + aa;
+        if (denom == 0.0) {
+            break;
+        }
+        lambda -= (aa * lambda + c0) / denom;
+        rmsd = std::sqrt(std::abs(2.0 * (e0 - lambda) / n));
+        if (std::abs(lambda - lambda_old) < std::abs(evalprec * lambda)) {
+            break;
+        }
+        if (rmsd > rmsd_max) { // RMSD can only grow from here
+            break;
+        }
+    }
+    return rmsd;
+}
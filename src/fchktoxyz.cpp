@@ -4,14 +4,15 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <chem/decompress_stream.h>
 #include <chem/gauss_data.h>
 #include <chem/periodic_table.h>
 #include <numlib/constants.h>
 #include <stdutils/stdutils.h>
 #include <exception>
-#include <fstream>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
 // Extracts current Cartesian coordinates from a Gaussian fchk.gz file
@@ -33,8 +34,10 @@ int main(int argc, char* argv[])
     }
 
     try {
-        std::ifstream from;
-        Stdutils::fopen(from, filename);
+        Chem::Decompress_istream from(filename);
+        if (!from) {
+            throw std::runtime_error("cannot open " + filename);
+        }
 
         // Get current Cartesian coordinates:
 
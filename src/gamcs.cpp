@@ -10,6 +10,8 @@
 #pragma warning(disable : 4996)      // caused by ctime
 #endif
 
+#include <chem/cascade.h>
+#include <chem/forcefield.h>
 #include <chem/gaussian.h>
 #include <chem/mopac.h>
 #include <chem/gamcs.h>
@@ -31,7 +33,7 @@ int main(int argc, char* argv[])
     options.add_options()
         ("h,help", "display help message")
         ("f,file", "input file", cxxopts::value<std::string>()) 
-		("p,pot", "potential (Gaussian or Mopac)", cxxopts::value<std::string>());
+		("p,pot", "potential (Gaussian, Mopac, Forcefield or cascade Cheap+Expensive)", cxxopts::value<std::string>());
     // clang-format on
 
     auto args = options.parse(argc, argv);
@@ -72,6 +74,25 @@ int main(int argc, char* argv[])
             Chem::Gamcs<Chem::Gaussian> ga(from, to);
             ga.solve(to);
         }
+        else if (pot == "Forcefield" || pot == "forcefield") {
+            Chem::Gamcs<Chem::Forcefield> ga(from, to);
+            ga.solve(to);
+        }
+        else if (pot == "Forcefield+Gaussian") {
+            Chem::Gamcs<Chem::Cascade<Chem::Forcefield, Chem::Gaussian>> ga(
+                from, to);
+            ga.solve(to);
+        }
+        else if (pot == "Forcefield+Mopac") {
+            Chem::Gamcs<Chem::Cascade<Chem::Forcefield, Chem::Mopac>> ga(
+                from, to);
+            ga.solve(to);
+        }
+        else if (pot == "Mopac+Gaussian") {
+            Chem::Gamcs<Chem::Cascade<Chem::Mopac, Chem::Gaussian>> ga(
+                from, to);
+            ga.solve(to);
+        }
         else {
             Chem::Gamcs<Chem::Mopac> ga(from, to);
             ga.solve(to);
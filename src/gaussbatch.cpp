@@ -0,0 +1,449 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4018 4267) // caused by cxxopts.hpp
+#endif
+
+#include <chem/decompress_stream.h>
+#include <chem/gauss_data.h>
+#include <numlib/matrix.h>
+#include <stdutils/stdutils.h>
+#include <cxxopts.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <glob.h>
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+//  Extracts data from many Gaussian output or formatted checkpoint files
+//  and writes one table with the results in input order.
+//
+//  The files are processed in parallel by the OpenMP thread pool; the
+//  number of threads is set by OMP_NUM_THREADS. Files that cannot be
+//  processed are reported on stderr without stopping the batch.
+//
+//  Each table row holds the file name, an optional label and a fixed
+//  number of values, which depend on the query:
+//
+//    energy:  scf, zpe, total
+//    freq:    mode, freq
+//    scan:    coordinate (label); point, coord, energy
+//    nmr:     atoms (label); peak, shielding, degeneracy
+//    hess:    row, col, value (lower triangle; fchk files)
+//
+//  The binary table has the following layout in host byte order, where
+//  strings are written as a uint32 length followed by the characters:
+//
+//    char[8]   "CHEMTAB1"
+//    uint32    number of value columns, ncols
+//    string    label column name (empty if there is no label)
+//    string    value column names (ncols)
+//    uint32    number of files, nfiles
+//    string    file names (nfiles)
+//    uint64    number of rows
+//    rows:     uint32 file index, string label, double values (ncols)
+//
+
+namespace {
+
+// Struct for holding one table row.
+struct Row {
+    std::string label;
+    std::vector<double> val;
+};
+
+// Struct for holding a query and the table columns it produces.
+struct Query {
+    Chem::Gauss_filetype type;
+    std::string label;
+    std::vector<std::string> cols;
+    std::function<void(const Chem::Gauss_data&, std::vector<Row>&)> extract;
+};
+
+// Struct for holding the result of processing one file.
+struct Result {
+    std::vector<Row> rows;
+    std::string error;
+};
+
+//------------------------------------------------------------------------------
+
+Query make_query(const std::string& name,
+                 const std::string& nmr_method,
+                 double degen_tol)
+{
+    Query q;
+    q.type = Chem::out;
+    if (name == "energy") {
+        q.cols = {"scf", "zpe", "total"};
+        q.extract = [](const Chem::Gauss_data& gauss, std::vector<Row>& rows) {
+            auto en = gauss.get_scf_zpe_energy();
+            if (en[0] == 0.0 && en[1] == 0.0) {
+                throw std::runtime_error("no energies found");
+            }
+            rows.push_back({"", {en[0], en[1], en[0] + en[1]}});
+        };
+    }
+    else if (name == "freq") {
+        q.cols = {"mode", "freq"};
+        q.extract = [](const Chem::Gauss_data& gauss, std::vector<Row>& rows) {
+            std::vector<double> freqs;
+            gauss.get_freqs(freqs);
+            if (freqs.empty()) {
+                throw std::runtime_error("no frequencies found");
+            }
+            for (std::size_t i = 0; i < freqs.size(); ++i) {
+                rows.push_back({"", {static_cast<double>(i + 1), freqs[i]}});
+            }
+        };
+    }
+    else if (name == "scan") {
+        q.label = "coordinate";
+        q.cols = {"point", "coord", "energy"};
+        q.extract = [](const Chem::Gauss_data& gauss, std::vector<Row>& rows) {
+            std::string scan_coord;
+            std::vector<double> coord;
+            std::vector<double> energy;
+            gauss.get_pes_scan_data(scan_coord, coord, energy);
+            if (energy.empty()) {
+                throw std::runtime_error("no scan data found");
+            }
+            for (std::size_t i = 0; i < energy.size(); ++i) {
+                rows.push_back({scan_coord,
+                                {static_cast<double>(i + 1), coord[i],
+                                 energy[i]}});
+            }
+        };
+    }
+    else if (name == "nmr") {
+        q.label = "atoms";
+        q.cols = {"peak", "shielding", "degeneracy"};
+        q.extract = [=](const Chem::Gauss_data& gauss,
+                        std::vector<Row>& rows) {
+            std::vector<Chem::Gauss_NMR> nmr;
+            gauss.get_nmr_data(nmr, nmr_method, degen_tol);
+            if (nmr.empty()) {
+                throw std::runtime_error("no NMR data found");
+            }
+            for (std::size_t i = 0; i < nmr.size(); ++i) {
+                auto& ni = nmr[i];
+                std::sort(ni.number.begin(), ni.number.end());
+                std::string atoms = ni.atom;
+                for (std::size_t j = 0; j < ni.number.size(); ++j) {
+                    atoms += (j == 0 ? " " : ",") + std::to_string(ni.number[j]);
+                }
+                const auto degen = static_cast<double>(ni.shield.size());
+                double shield =
+                    std::accumulate(ni.shield.begin(), ni.shield.end(), 0.0) /
+                    degen;
+                rows.push_back(
+                    {atoms, {static_cast<double>(i + 1), shield, degen}});
+            }
+        };
+    }
+    else if (name == "hess") {
+        q.type = Chem::fchk;
+        q.cols = {"row", "col", "value"};
+        q.extract = [](const Chem::Gauss_data& gauss, std::vector<Row>& rows) {
+            Numlib::Symm_mat<double, Numlib::lo> hess;
+            gauss.get_hessians(hess);
+            if (hess.size() == 0) {
+                throw std::runtime_error("no force constants found");
+            }
+            for (Index i = 0; i < hess.rows(); ++i) {
+                for (Index j = 0; j <= i; ++j) {
+                    rows.push_back({"",
+                                    {static_cast<double>(i + 1),
+                                     static_cast<double>(j + 1), hess(i, j)}});
+                }
+            }
+        };
+    }
+    else {
+        throw std::runtime_error("unknown query: " + name);
+    }
+    return q;
+}
+
+//------------------------------------------------------------------------------
+
+bool is_pattern(const std::string& name)
+{
+    return name.find_first_of("*?[") != std::string::npos;
+}
+
+// Expand glob pattern; the pattern is returned as is if nothing matches,
+// so that the failure is reported for the file.
+void expand(const std::string& name, std::vector<std::string>& files)
+{
+#ifndef _WIN32
+    if (is_pattern(name)) {
+        glob_t res;
+        if (glob(name.c_str(), 0, nullptr, &res) == 0) {
+            for (std::size_t i = 0; i < res.gl_pathc; ++i) {
+                files.emplace_back(res.gl_pathv[i]);
+            }
+            globfree(&res);
+            return;
+        }
+        globfree(&res);
+    }
+#endif
+    files.push_back(name);
+}
+
+// Read file names or patterns, one per line.
+void read_list(const std::string& list_file, std::vector<std::string>& files)
+{
+    std::ifstream from;
+    Stdutils::fopen(from, list_file);
+
+    std::string line;
+    while (std::getline(from, line)) {
+        line = Stdutils::trim(line, " \t\r");
+        if (!line.empty() && line[0] != '#') {
+            expand(line, files);
+        }
+    }
+}
+
+Result process(const std::string& filename, const Query& query)
+{
+    Result res;
+    try {
+        Chem::Decompress_istream from(filename);
+        if (!from) {
+            throw std::runtime_error("cannot open file");
+        }
+        Chem::Gauss_data gauss(from, query.type);
+        query.extract(gauss, res.rows);
+    }
+    catch (std::exception& e) {
+        res.rows.clear();
+        res.error = e.what();
+    }
+    return res;
+}
+
+//------------------------------------------------------------------------------
+
+std::string csv_field(const std::string& str)
+{
+    if (str.find_first_of(",\"\n") == std::string::npos) {
+        return str;
+    }
+    std::string res = "\"";
+    for (auto c : str) {
+        if (c == '"') {
+            res += '"';
+        }
+        res += c;
+    }
+    return res + '"';
+}
+
+void write_csv(std::ostream& to,
+               const Query& query,
+               const std::vector<std::string>& files,
+               const std::vector<Result>& results)
+{
+    to << "file";
+    if (!query.label.empty()) {
+        to << ',' << query.label;
+    }
+    for (const auto& c : query.cols) {
+        to << ',' << c;
+    }
+    to << '\n';
+
+    to.precision(10);
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        const std::string file = csv_field(files[i]);
+        for (const auto& r : results[i].rows) {
+            to << file;
+            if (!query.label.empty()) {
+                to << ',' << csv_field(r.label);
+            }
+            for (auto v : r.val) {
+                to << ',' << v;
+            }
+            to << '\n';
+        }
+    }
+}
+
+template <class T>
+void write_value(std::ostream& to, T val)
+{
+    to.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+void write_string(std::ostream& to, const std::string& str)
+{
+    write_value(to, static_cast<std::uint32_t>(str.size()));
+    to.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+void write_binary(std::ostream& to,
+                  const Query& query,
+                  const std::vector<std::string>& files,
+                  const std::vector<Result>& results)
+{
+    to.write("CHEMTAB1", 8);
+    write_value(to, static_cast<std::uint32_t>(query.cols.size()));
+    write_string(to, query.label);
+    for (const auto& c : query.cols) {
+        write_string(to, c);
+    }
+    write_value(to, static_cast<std::uint32_t>(files.size()));
+    for (const auto& f : files) {
+        write_string(to, f);
+    }
+    std::uint64_t nrows = 0;
+    for (const auto& r : results) {
+        nrows += r.rows.size();
+    }
+    write_value(to, nrows);
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        for (const auto& r : results[i].rows) {
+            write_value(to, static_cast<std::uint32_t>(i));
+            write_string(to, r.label);
+            to.write(reinterpret_cast<const char*>(r.val.data()),
+                     static_cast<std::streamsize>(r.val.size() *
+                                                  sizeof(double)));
+        }
+    }
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // clang-format off
+    cxxopts::Options options(argv[0], "Extract data from many Gaussian files");
+    options.positional_help("files...");
+    options.add_options()
+        ("h,help", "display help message")
+        ("q,query", "data to extract: energy, freq, scan, nmr or hess", cxxopts::value<std::string>())
+        ("l,list", "file with file names or glob patterns, one per line", cxxopts::value<std::string>())
+        ("o,output", "output file (default is stdout)", cxxopts::value<std::string>())
+        ("b,binary", "write binary table (requires output file)")
+        ("m,method", "NMR method (default is GIAO)", cxxopts::value<std::string>())
+        ("t,tol", "NMR degeneracy tolerance (default is 0.05)", cxxopts::value<double>())
+        ("files", "Gaussian files or glob patterns", cxxopts::value<std::vector<std::string>>());
+    // clang-format on
+    options.parse_positional({"files"});
+
+    try {
+        auto args = options.parse(argc, argv);
+
+        if (args.count("help")) {
+            std::cout << options.help({"", "Group"}) << '\n';
+            return 0;
+        }
+        if (!args.count("query") ||
+            (!args.count("files") && !args.count("list"))) {
+            std::cerr << options.help({"", "Group"}) << '\n';
+            return 1;
+        }
+
+        std::string nmr_method = "SCF GIAO"; // default NMR method
+        double degen_tol = 0.05;             // default degeneracy tolerance
+        if (args.count("method")) {
+            nmr_method = args["method"].as<std::string>();
+        }
+        if (args.count("tol")) {
+            degen_tol = args["tol"].as<double>();
+        }
+        const Query query =
+            make_query(args["query"].as<std::string>(), nmr_method, degen_tol);
+
+        const bool binary = args.count("binary") > 0;
+        if (binary && !args.count("output")) {
+            throw std::runtime_error("binary table requires an output file");
+        }
+
+        // Collect files in input order:
+
+        std::vector<std::string> files;
+        if (args.count("list")) {
+            read_list(args["list"].as<std::string>(), files);
+        }
+        if (args.count("files")) {
+            for (const auto& name :
+                 args["files"].as<std::vector<std::string>>()) {
+                expand(name, files);
+            }
+        }
+
+        // Process files; the results are stored by input index:
+
+        std::vector<Result> results(files.size());
+        const auto n = static_cast<long>(files.size());
+#pragma omp parallel for schedule(dynamic)
+        for (long i = 0; i < n; ++i) {
+            results[i] = process(files[i], query);
+        }
+
+        // Write table:
+
+        std::ofstream fout;
+        if (args.count("output")) {
+            auto mode = std::ios_base::out;
+            if (binary) {
+                mode |= std::ios_base::binary;
+            }
+            fout.open(args["output"].as<std::string>(), mode);
+            if (!fout) {
+                throw std::runtime_error("cannot open " +
+                                         args["output"].as<std::string>());
+            }
+        }
+        std::ostream& to = fout.is_open() ? fout : std::cout;
+        if (binary) {
+            write_binary(to, query, files, results);
+        }
+        else {
+            write_csv(to, query, files, results);
+        }
+
+        // Report failures:
+
+        int nfail = 0;
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            if (!results[i].error.empty()) {
+                std::cerr << files[i] << ": " << results[i].error << '\n';
+                ++nfail;
+            }
+        }
+        if (nfail > 0) {
+            std::cerr << nfail << " of " << files.size()
+                      << " files failed\n";
+            return 1;
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "what: " << e.what() << '\n';
+        return 1;
+    }
+}
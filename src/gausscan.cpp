@@ -4,11 +4,12 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <chem/decompress_stream.h>
 #include <chem/gauss_data.h>
 #include <stdutils/stdutils.h>
 #include <exception>
-#include <fstream>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -23,8 +24,10 @@ int main(int argc, char* argv[])
     }
 
     try {
-        std::ifstream from;
-        Stdutils::fopen(from, args[1]);
+        Chem::Decompress_istream from(args[1]);
+        if (!from) {
+            throw std::runtime_error("cannot open " + args[1]);
+        }
 
         std::string scan_coord;
         std::vector<double> coord;
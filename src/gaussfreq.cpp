@@ -4,9 +4,9 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <chem/decompress_stream.h>
 #include <chem/gauss_data.h>
 #include <stdutils/stdutils.h>
-#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <string>
@@ -22,7 +22,7 @@ int main(int argc, char* argv[])
         return 1;
     }
 
-    std::ifstream from(args[1]);
+    Chem::Decompress_istream from(args[1]);
     if (!from) {
         std::cerr << "cannot open " << args[1] << '\n';
         return 1;
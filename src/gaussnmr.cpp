@@ -9,12 +9,12 @@
 #pragma warning(disable : 4018 4267) // caused by cxxopts.hpp
 #endif
 
+#include <chem/decompress_stream.h>
 #include <chem/gauss_data.h>
 #include <stdutils/stdutils.h>
 #include <cxxopts.hpp>
 #include <algorithm>
 #include <exception>
-#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <string>
@@ -62,8 +62,11 @@ int main(int argc, char* argv[])
         degen_tol = args["tol"].as<double>();
     }
 
-    std::ifstream from;
-    Stdutils::fopen(from, input_file);
+    Chem::Decompress_istream from(input_file);
+    if (!from) {
+        std::cerr << "cannot open " << input_file << '\n';
+        return 1;
+    }
 
     // Get NMR data:
 
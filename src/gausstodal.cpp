@@ -4,12 +4,12 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <chem/decompress_stream.h>
 #include <chem/gauss_data.h>
 #include <chem/periodic_table.h>
 #include <numlib/traits.h>
 #include <stdutils/stdutils.h>
 #include <iostream>
-#include <fstream>
 #include <vector>
 
 // Get Cartesian coordinates from Gaussian output file and convert to
@@ -23,7 +23,7 @@ int main(int argc, char* argv[])
         return 1;
     }
 
-    std::ifstream from(args[1]);
+    Chem::Decompress_istream from(args[1]);
     if (!from) {
         std::cerr << "cannot open " << args[1] << '\n';
         return 1;
@@ -38,9 +38,6 @@ bool reverse_mep;
 bool get_hess;
 
 std::vector<double> mep;
-std::vector<double> geom;
-std::vector<double> grad;
-std::vector<double> hess;
 
 //------------------------------------------------------------------------------
 
@@ -50,7 +47,8 @@ struct Error : std::runtime_error {
 
 //------------------------------------------------------------------------------
 
-void create_fu31(const Chem::Gauss_filetype filetype);
+void create_fu31(const Chem::Gauss_data& gauss,
+                 const Chem::Gauss_filetype filetype);
 Chem::Gauss_filetype get_filetype(const char* filename);
 
 //------------------------------------------------------------------------------
@@ -121,18 +119,16 @@ int main(int argc, char* argv[])
         Stdutils::fopen(from, input_file);
 
         Chem::Gauss_filetype filetype = get_filetype(input_file.c_str());
+        if (get_hess && filetype == Chem::fchk) {
+            throw Error("IRC Hessians can only be extracted from Gaussian "
+                        "output files");
+        }
 
         Chem::Gauss_data gauss(from, filetype);
 
         natoms = gauss.get_natoms();
 
         gauss.get_irc_data(mep);
-        gauss.get_irc_geom(geom);
-        gauss.get_irc_grad(grad);
-
-        if (get_hess) {
-            gauss.get_irc_hess(hess);
-        }
 
         if (reverse_mep) {
             std::vector<double> mep_tmp(mep.size());
@@ -148,7 +144,7 @@ int main(int argc, char* argv[])
             }
             mep = mep_tmp;
         }
-        create_fu31(filetype);
+        create_fu31(gauss, filetype);
     }
     catch (std::exception& e) {
         std::cerr << "what: " << e.what() << '\n';
@@ -172,7 +168,10 @@ Chem::Gauss_filetype get_filetype(const char* filename)
     }
 }
 
-void create_fu31(const Chem::Gauss_filetype filetype)
+// Geometries, gradients and Hessians are read one point at a time, so
+// memory use does not grow with the length of the path.
+void create_fu31(const Chem::Gauss_data& gauss,
+                 const Chem::Gauss_filetype filetype)
 {
     const char* output_file = "gauss2poly.fu31";
 
@@ -199,10 +198,12 @@ void create_fu31(const Chem::Gauss_filetype filetype)
     double smep;
     double vmep;
 
+    std::vector<double> geom;
+    std::vector<double> grad;
+    std::vector<double> hess;
+
     std::size_t indx1 = 0;
     std::size_t indx2 = 1;
-    std::size_t indx3 = 0;
-    std::size_t indx4 = 0;
     std::size_t count = 0;
 
     for (std::size_t i = 0; i < npoints; i++) {
@@ -218,10 +219,13 @@ void create_fu31(const Chem::Gauss_filetype filetype)
            << " SMEP\t" << sci(smep) << "\n\n"
            << " VMEP\t" << sci(vmep) << "\n\n";
 
+        gauss.get_irc_geom(static_cast<int>(i), geom);
+        gauss.get_irc_grad(static_cast<int>(i), grad);
+
         to << " GEOM \n";
         count = 0;
         for (std::size_t j = 0; j < natoms3; j++) {
-            to << fix(geom[indx3 + j] * conv_factor);
+            to << fix(geom[j] * conv_factor);
             count++;
             if (count == 3) {
                 to << '\n';
@@ -233,7 +237,7 @@ void create_fu31(const Chem::Gauss_filetype filetype)
         to << " GRADS \n";
         count = 0;
         for (std::size_t j = 0; j < natoms3; j++) {
-            to << sci(grad[indx3 + j]);
+            to << sci(grad[j]);
             count++;
             if (count == 3) {
                 to << '\n';
@@ -243,10 +247,12 @@ void create_fu31(const Chem::Gauss_filetype filetype)
         to << " END \n\n";
 
         if (get_hess) {
+            gauss.get_irc_hess(static_cast<int>(i), hess);
+
             to << " HESSIANS \n";
             count = 0;
             for (std::size_t j = 0; j < nhess; j++) {
-                to << sci(hess[indx4 + j]);
+                to << sci(hess[j]);
                 count++;
                 if (count == 5) {
                     to << '\n';
@@ -260,8 +266,6 @@ void create_fu31(const Chem::Gauss_filetype filetype)
         }
         indx1 += 2;
         indx2 += 2;
-        indx3 += natoms3;
-        indx4 += nhess;
     }
     std::cout << "output is written to " << output_file << '\n';
 }
@@ -4,6 +4,7 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <chem/mapped_file.h>
 #include <stdutils/stdutils.h>
 #include <exception>
 #include <fstream>
@@ -30,8 +31,8 @@ struct Run_error : std::runtime_error {
 
 void parse_inp(const std::string& inpfile, std::string& runtyp);
 void parse_log(const std::string& logfile, const std::string& runtyp);
-void extract_optimized_energy(std::istream& from);
-void extract_zpe(std::istream& from);
+void extract_optimized_energy(Chem::Line_reader& from);
+void extract_zpe(Chem::Line_reader& from);
 
 //------------------------------------------------------------------------------
 
@@ -93,10 +94,11 @@ void parse_inp(const std::string& inpfile, std::string& runtyp)
 // Extract data from GAMESS output file.
 void parse_log(const std::string& logfile, const std::string& runtyp)
 {
-    std::ifstream from(logfile.c_str());
-    if (!from) {
+    Chem::Mapped_file file;
+    if (!file.open(logfile)) {
         throw IO_error("cannot open " + logfile);
     }
+    Chem::Line_reader from(file.view());
     if (runtyp == "OPTIMIZE") {
         extract_optimized_energy(from);
     }
@@ -109,21 +111,19 @@ void parse_log(const std::string& logfile, const std::string& runtyp)
 }
 
 // Extract electronic energy for optimized geometry.
-void extract_optimized_energy(std::istream& from)
+void extract_optimized_energy(Chem::Line_reader& from)
 {
     const std::string pat_opt = "***** EQUILIBRIUM GEOMETRY LOCATED *****";
     const std::string pat_e = "TOTAL ENERGY";
 
-    std::string line;
-    std::string tmp;
+    Chem::Text_view line;
     std::string energy; // a bit dangerous, but easy (avoids loss of decimals)
 
-    while (std::getline(from, line)) {
-        if (line.find(pat_opt, 0) != std::string::npos) {
-            while (std::getline(from, line)) {
-                if (line.find(pat_e, 0) != std::string::npos) {
-                    std::istringstream iss(line);
-                    iss >> tmp >> tmp >> tmp >> energy;
+    while (from.next(line)) {
+        if (line.contains(pat_opt)) {
+            while (from.next(line)) {
+                if (line.contains(pat_e)) {
+                    energy = Chem::get_token(line, 3).str();
                     std::cout << "  " << pat_e << " = " << energy << '\n';
                     return; // success
                 }
@@ -134,18 +134,17 @@ void extract_optimized_energy(std::istream& from)
 }
 
 // Extract zero-point vibrational energy.
-void extract_zpe(std::istream& from)
+void extract_zpe(Chem::Line_reader& from)
 {
     const std::string pat_zpe = "THE HARMONIC ZERO POINT ENERGY IS";
 
-    std::string line;
+    Chem::Text_view line;
     std::string zpe; // a bit dangerous, but easy (avoids loss of decimals)
 
-    while (std::getline(from, line)) {
-        if (line.find(pat_zpe, 0) != std::string::npos) {
-            std::getline(from, line);
-            std::istringstream iss(line);
-            iss >> zpe;
+    while (from.next(line)) {
+        if (line.contains(pat_zpe)) {
+            from.next(line);
+            zpe = Chem::get_token(line, 0).str();
             std::cout << "  ZERO POINT ENERGY = " << zpe << '\n';
             return; // success
         }
@@ -14,16 +14,42 @@
 #endif
 
 #include <chem/ising.h>
+#include <chem/ising_msc.h>
+#include <chem/ising_pt.h>
+#include <chem/ising_wl.h>
 #include <cxxopts.hpp>
 #include <exception>
 #include <iostream>
 #include <cmath>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
 
+// Run sampler over temperature range.
+template <typename Sampler>
+void run(const std::string& header,
+         Sampler sampler,
+         double t0,
+         double t1,
+         int ntemp)
+{
+    std::cout << header << '\n';
+
+    auto temp = Numlib::linspace(t0, t1, ntemp);
+    for (auto& ti : temp) {
+        auto res = sampler(ti);
+        std::cout << ti;
+        for (auto ri : res) {
+            std::cout << "," << ri;
+        }
+        std::cout << std::endl;
+    }
+}
+
 // Program providing two-dimensional Ising solver.
 //
 int main(int argc, char* argv[])
@@ -39,7 +65,14 @@ int main(int argc, char* argv[])
         ("t1", "final temperature", cxxopts::value<double>()) 
         ("ntemp", "number of temperature steps", cxxopts::value<int>()) 
         ("trials", "number of Monte Carlo trials", cxxopts::value<int>()->default_value("1000")) 
-        ("viz", "vizualisation steps", cxxopts::value<std::vector<int>>());
+        ("viz", "vizualisation steps", cxxopts::value<std::vector<int>>())
+        ("corr", "sweeps between structure factor measurements (adds correlation length)", cxxopts::value<int>()->default_value("0"))
+        ("snap", "snapshot file for vizualisation steps", cxxopts::value<std::string>()->default_value("ising.snap"))
+        ("algo", "algorithm (metropolis, wolff, sw, pt or wl)", cxxopts::value<std::string>()->default_value("metropolis"))
+        ("nrw", "number of reweighted temperatures with pt", cxxopts::value<int>()->default_value("0"))
+        ("nwin", "number of energy windows with wl", cxxopts::value<int>()->default_value("4"))
+        ("lnf", "final modification factor with wl", cxxopts::value<double>()->default_value("1.0e-6"))
+        ("msc", "use multi-spin coding with metropolis (size must be a multiple of 128)");
     // clang-format on
 
     auto args = options.parse(argc, argv);
@@ -47,13 +80,19 @@ int main(int argc, char* argv[])
     int size = 0;
     int ntemp = 0;
     int trials = 0;
+    int nrw = 0;
+    int nwin = 0;
+    int corr = 0;
 
     double t0 = 0.0;
     double t1 = 0.0;
     double jint = 0.0;
     double bfield = 0.0;
+    double lnf = 0.0;
 
     std::vector<int> viz;
+    std::string snap;
+    std::string algo;
 
     if (args.count("help")) {
         std::cout << options.help({"", "Group"}) << '\n';
@@ -77,16 +116,96 @@ int main(int argc, char* argv[])
     trials = args["trials"].as<int>();
     jint = args["jint"].as<double>();
     bfield = args["bfield"].as<double>();
+    corr = args["corr"].as<int>();
+    snap = args["snap"].as<std::string>();
+    algo = args["algo"].as<std::string>();
+    nrw = args["nrw"].as<int>();
+    nwin = args["nwin"].as<int>();
+    lnf = args["lnf"].as<double>();
 
     try {
-        Chem::Ising2D mod(size, jint, bfield, viz);
-        std::cout << "T,E,<M>,Cv,X\n";
+        const std::string header = "T,E,<M>,Cv,X";
+        if (args.count("msc")) {
+            if (algo != "metropolis") {
+                throw std::runtime_error(
+                    "multi-spin coding requires metropolis");
+            }
+            Chem::Ising2D_msc mod(size, jint, bfield, viz);
+            mod.set_snapshot_file(snap);
+            run(header, [&](double ti) { return mod.metropolis(ti, trials); },
+                t0, t1, ntemp);
+        }
+        else if (algo == "pt") {
+            // Replicas are run at all temperatures concurrently; results
+            // between them are obtained by reweighting the histograms:
+            auto temp = Numlib::linspace(t0, t1, ntemp);
+            std::vector<double> tv(temp.begin(), temp.end());
+            Chem::Ising2D_pt mod(size, jint, bfield, tv);
+            auto res = mod.tempering(trials);
+
+            std::cout << header << '\n';
+            if (nrw > 0) {
+                auto trw = Numlib::linspace(t0, t1, nrw);
+                for (auto& ti : trw) {
+                    auto ri = mod.reweight(ti);
+                    std::cout << ti << "," << ri[0] << "," << ri[1] << ","
+                              << ri[2] << "," << ri[3] << std::endl;
+                }
+            }
+            else {
+                for (std::size_t k = 0; k < tv.size(); ++k) {
+                    std::cout << tv[k] << "," << res[k][0] << ","
+                              << res[k][1] << "," << res[k][2] << ","
+                              << res[k][3] << std::endl;
+                }
+            }
+        }
+        else if (algo == "wl") {
+            // All temperatures are obtained from the density of states:
+            if (bfield != 0.0) {
+                throw std::runtime_error("wl requires zero field");
+            }
+            Chem::Ising2D_wl mod(size, jint, nwin);
+            mod.wang_landau(lnf);
+            run(header, [&](double ti) { return mod.thermo(ti); }, t0, t1,
+                ntemp);
+        }
+        else {
+            Chem::Ising2D mod(size, jint, bfield, viz);
+            mod.set_snapshot_file(snap);
+            mod.set_corr_stride(corr);
 
-        auto temp = Numlib::linspace(t0, t1, ntemp);
-        for (auto& ti : temp) {
-            auto res = mod.metropolis(ti, trials);
-            std::cout << ti << "," << res[0] << "," << std::abs(res[1]) << ","
-                      << res[2] << "," << res[3] << std::endl;
+            // Append correlation length to results if measured:
+            auto with_xi = [&](auto res) {
+                std::vector<double> out(res.begin(), res.end());
+                if (corr > 0) {
+                    out.push_back(mod.correlation_length());
+                }
+                return out;
+            };
+            const std::string xi = corr > 0 ? ",xi" : "";
+            if (algo == "metropolis") {
+                run(header + xi,
+                    [&](double ti) {
+                        return with_xi(mod.metropolis(ti, trials));
+                    },
+                    t0, t1, ntemp);
+            }
+            else if (algo == "wolff") {
+                run(header + ",tau_E,tau_M" + xi,
+                    [&](double ti) { return with_xi(mod.wolff(ti, trials)); },
+                    t0, t1, ntemp);
+            }
+            else if (algo == "sw") {
+                run(header + ",tau_E,tau_M" + xi,
+                    [&](double ti) {
+                        return with_xi(mod.swendsen_wang(ti, trials));
+                    },
+                    t0, t1, ntemp);
+            }
+            else {
+                throw std::runtime_error("unknown algorithm: " + algo);
+            }
         }
     }
     catch (std::exception& e) {
@@ -0,0 +1,210 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4018 4267) // caused by cxxopts.hpp
+#endif
+
+#include <chem/ising_snapshot.h>
+#include <stdutils/stdutils.h>
+#include <cxxopts.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+//------------------------------------------------------------------------------
+
+// Write spins in CSV format.
+void write_csv(const std::string& fname,
+               const std::vector<int>& spins,
+               int rows,
+               int cols)
+{
+    std::ofstream to;
+    Stdutils::fopen(to, fname);
+
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols - 1; ++j) {
+            to << spins[i * cols + j] << ",";
+        }
+        to << spins[i * cols + cols - 1] << '\n';
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Compute CRC-32 checksum as required by PNG.
+std::uint32_t crc32(const std::vector<std::uint8_t>& data, std::size_t first)
+{
+    static std::vector<std::uint32_t> table;
+    if (table.empty()) {
+        table.resize(256);
+        for (std::uint32_t n = 0; n < 256; ++n) {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+    }
+    std::uint32_t c = 0xffffffffu;
+    for (std::size_t i = first; i < data.size(); ++i) {
+        c = table[(c ^ data[i]) & 0xff] ^ (c >> 8);
+    }
+    return c ^ 0xffffffffu;
+}
+
+// Append big-endian 32-bit integer.
+void put_uint32(std::vector<std::uint8_t>& data, std::uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        data.push_back(static_cast<std::uint8_t>(value >> shift));
+    }
+}
+
+// Append PNG chunk.
+void put_chunk(std::vector<std::uint8_t>& png,
+               const char* type,
+               const std::vector<std::uint8_t>& data)
+{
+    put_uint32(png, static_cast<std::uint32_t>(data.size()));
+    const std::size_t first = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), data.begin(), data.end());
+    put_uint32(png, crc32(png, first));
+}
+
+// Write spins as 8-bit grayscale PNG image, with up spins white and each
+// spin drawn as a square of scale pixels. The image data is stored in
+// uncompressed deflate blocks, so no compression library is needed.
+void write_png(const std::string& fname,
+               const std::vector<int>& spins,
+               int rows,
+               int cols,
+               int scale)
+{
+    const std::uint32_t width = cols * scale;
+    const std::uint32_t height = rows * scale;
+
+    // Scanlines, each preceded by filter type 0:
+    std::vector<std::uint8_t> raw;
+    raw.reserve((width + 1) * height);
+    for (int i = 0; i < rows; ++i) {
+        for (int si = 0; si < scale; ++si) {
+            raw.push_back(0);
+            for (int j = 0; j < cols; ++j) {
+                const std::uint8_t px = spins[i * cols + j] > 0 ? 255 : 0;
+                raw.insert(raw.end(), scale, px);
+            }
+        }
+    }
+
+    // Zlib stream with stored blocks:
+    std::vector<std::uint8_t> idat = {0x78, 0x01};
+    const std::size_t max_block = 65535;
+    std::size_t pos = 0;
+    do {
+        const std::size_t len = std::min(max_block, raw.size() - pos);
+        const bool last = pos + len == raw.size();
+        idat.push_back(last ? 1 : 0);
+        idat.push_back(static_cast<std::uint8_t>(len & 0xff));
+        idat.push_back(static_cast<std::uint8_t>(len >> 8));
+        idat.push_back(static_cast<std::uint8_t>(~len & 0xff));
+        idat.push_back(static_cast<std::uint8_t>((~len >> 8) & 0xff));
+        idat.insert(idat.end(), raw.begin() + pos, raw.begin() + pos + len);
+        pos += len;
+    } while (pos < raw.size());
+
+    std::uint32_t a = 1;
+    std::uint32_t b = 0;
+    for (auto c : raw) { // Adler-32 checksum
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    put_uint32(idat, (b << 16) | a);
+
+    std::vector<std::uint8_t> ihdr;
+    put_uint32(ihdr, width);
+    put_uint32(ihdr, height);
+    ihdr.insert(ihdr.end(), {8, 0, 0, 0, 0}); // 8-bit grayscale
+
+    std::vector<std::uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a,
+                                     '\n'};
+    put_chunk(png, "IHDR", ihdr);
+    put_chunk(png, "IDAT", idat);
+    put_chunk(png, "IEND", {});
+
+    std::ofstream to;
+    Stdutils::fopen(to, fname, std::ios_base::out | std::ios_base::binary);
+    to.write(reinterpret_cast<const char*>(png.data()),
+             static_cast<std::streamsize>(png.size()));
+}
+
+//------------------------------------------------------------------------------
+
+// Program converting Ising snapshot files to CSV files or PNG images, with
+// one file per frame.
+//
+int main(int argc, char* argv[])
+{
+    // clang-format off
+    cxxopts::Options options(argv[0], "Convert Ising snapshot files");
+    options.add_options()
+        ("h,help", "display help message")
+        ("f,file", "snapshot file", cxxopts::value<std::string>()->default_value("ising.snap"))
+        ("format", "output format (csv or png)", cxxopts::value<std::string>()->default_value("csv"))
+        ("scale", "pixels per spin with png", cxxopts::value<int>()->default_value("1"));
+    // clang-format on
+
+    auto args = options.parse(argc, argv);
+
+    if (args.count("help")) {
+        std::cout << options.help({"", "Group"}) << '\n';
+        return 0;
+    }
+    auto snap_file = args["file"].as<std::string>();
+    auto format = args["format"].as<std::string>();
+    auto scale = args["scale"].as<int>();
+
+    try {
+        if (format != "csv" && format != "png") {
+            throw std::runtime_error("unknown format: " + format);
+        }
+        if (scale < 1) {
+            throw std::runtime_error("bad scale: " + std::to_string(scale));
+        }
+        Chem::Snapshot_reader snap(snap_file);
+
+        double temp;
+        int it;
+        std::vector<int> spins;
+        for (std::size_t k = 0; k < snap.size(); ++k) {
+            snap.read(k, temp, it, spins);
+            std::string fname = "ising_T" + std::to_string(temp) + "_N" +
+                                std::to_string(it) + "." + format;
+            if (format == "csv") {
+                write_csv(fname, spins, snap.rows(), snap.cols());
+            }
+            else {
+                write_png(fname, spins, snap.rows(), snap.cols(), scale);
+            }
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "what: " << e.what() << '\n';
+        return 1;
+    }
+}
@@ -9,6 +9,8 @@
 #pragma warning(disable : 4018 4267) // caused by cxxopts.hpp
 #endif
 
+#include <chem/cascade.h>
+#include <chem/forcefield.h>
 #include <chem/gaussian.h>
 #include <chem/mcmm.h>
 #include <chem/molecule.h>
@@ -33,7 +35,7 @@ int main(int argc, char* argv[])
     options.add_options()
         ("h,help", "display help message")
         ("f,file", "input file", cxxopts::value<std::string>()) 
-		("p,pot", "potential (Gaussian or Mopac)", cxxopts::value<std::string>());
+		("p,pot", "potential (Gaussian, Mopac, Forcefield or cascade Cheap+Expensive)", cxxopts::value<std::string>());
     // clang-format on
 
     auto args = options.parse(argc, argv);
@@ -65,6 +67,25 @@ int main(int argc, char* argv[])
             Chem::Mcmm<Chem::Gaussian> mc(from, mol, "Mcmm", true);
             mc.solve();
         }
+        else if (pot == "Forcefield" || pot == "forcefield") {
+            Chem::Mcmm<Chem::Forcefield> mc(from, mol, "Mcmm", true);
+            mc.solve();
+        }
+        else if (pot == "Forcefield+Gaussian") {
+            Chem::Mcmm<Chem::Cascade<Chem::Forcefield, Chem::Gaussian>> mc(
+                from, mol, "Mcmm", true);
+            mc.solve();
+        }
+        else if (pot == "Forcefield+Mopac") {
+            Chem::Mcmm<Chem::Cascade<Chem::Forcefield, Chem::Mopac>> mc(
+                from, mol, "Mcmm", true);
+            mc.solve();
+        }
+        else if (pot == "Mopac+Gaussian") {
+            Chem::Mcmm<Chem::Cascade<Chem::Mopac, Chem::Gaussian>> mc(
+                from, mol, "Mcmm", true);
+            mc.solve();
+        }
         else {
             Chem::Mcmm<Chem::Mopac> mc(from, mol, "Mcmm", true);
             mc.solve();
@@ -5,33 +5,24 @@
 // and conditions.
 
 #include <chem/gauss_data.h>
+#include <chem/irc_merge.h>
 #include <stdutils/stdutils.h>
 #include <exception>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
 //-----------------------------------------------------------------------------
 
-void print_array(std::ostream& to, const std::vector<double>& array);
-
-//-----------------------------------------------------------------------------
-
-const std::string pattern_irc_data =
-    "IRC point       1 Results for each geome   R   N=";
-
-const std::string pattern_irc_geom =
-    "IRC point       1 Geometries               R   N=";
-
-const std::string pattern_irc_grad =
-    "IRC point       1 Gradient at each geome   R   N=";
-
-//-----------------------------------------------------------------------------
-
-// Merge a set of files with Gaussian 98/03 IRC data which have been sorted.
+// Merge a set of formatted checkpoint files with Gaussian 98/03 IRC data
+// which have been sorted.
 //
-// Note: The input files must be in correct order.
+// The files may be given in any order; points are merged by reaction
+// coordinate in the direction of the first file, and duplicate points at
+// segment boundaries are written once. The points are streamed from the
+// files, which are kept open during the merge.
 //
 int main(int argc, char* argv[])
 {
@@ -42,74 +33,31 @@ int main(int argc, char* argv[])
     }
 
     try {
-        std::vector<double> mep;
-        std::vector<double> geom;
-        std::vector<double> grad;
-
-        std::ifstream from;
-        std::ofstream to;
-
-        const char* output_file = "mergeirc.out";
-        Stdutils::fopen(to, output_file);
-
-        int count = 1;
-        while (count < argc) {
-            auto input_file = args[count];
-            std::cout << "Reading " << input_file << " ...\n";
-            Stdutils::fopen(from, input_file);
-
-            Chem::Gauss_data gauss(from, Chem::fchk);
+        const std::size_t nfiles = args.size() - 1;
 
-            gauss.get_irc_data(mep);
-            gauss.get_irc_geom(geom);
-            gauss.get_irc_grad(grad);
+        std::vector<std::ifstream> from(nfiles);
+        std::vector<std::unique_ptr<Chem::Gauss_data>> gauss(nfiles);
+        std::vector<const Chem::Gauss_data*> segs(nfiles);
 
-            from.close();
-            count++;
+        for (std::size_t i = 0; i < nfiles; ++i) {
+            std::cout << "Reading " << args[i + 1] << " ...\n";
+            Stdutils::fopen(from[i], args[i + 1]);
+            gauss[i].reset(new Chem::Gauss_data(from[i], Chem::fchk));
+            segs[i] = gauss[i].get();
         }
 
-        Stdutils::Format<std::size_t> fmt;
-        fmt.width(12);
-
-        to << pattern_irc_data << fmt(mep.size()) << '\n';
-        print_array(to, mep);
+        std::ofstream to;
 
-        to << pattern_irc_geom << fmt(geom.size()) << '\n';
-        print_array(to, geom);
+        const char* output_file = "mergeirc.out";
+        Stdutils::fopen(to, output_file);
 
-        to << pattern_irc_grad << fmt(grad.size()) << '\n';
-        print_array(to, grad);
+        int npoints = Chem::merge_irc(segs, to);
 
-        std::cout << "\nOutput is written to " << output_file << '\n';
+        std::cout << "\nMerged " << npoints << " points\n"
+                  << "Output is written to " << output_file << '\n';
     }
     catch (std::exception& e) {
         std::cerr << e.what() << '\n';
         return 1;
     }
 }
-
-//------------------------------------------------------------------------------
-
-void print_array(std::ostream& to, const std::vector<double>& array)
-{
-    Stdutils::Format<double> sci;
-    sci.scientific_E().width(16).precision(8);
-
-    int count = 0;
-    bool wrote_endl = false;
-
-    for (const auto& vi : array) {
-        to << sci(vi);
-        count++;
-        wrote_endl = false;
-        if (count == 5) {
-            to << '\n';
-            count = 0;
-            wrote_endl = true;
-        }
-    }
-    if (!wrote_endl) {
-        to << '\n';
-    }
-}
-
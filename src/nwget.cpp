@@ -4,6 +4,7 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <chem/mapped_file.h>
 #include <stdutils/stdutils.h>
 #include <exception>
 #include <fstream>
@@ -30,9 +31,10 @@ void parse_nw(const std::string& nwfile,
               std::vector<std::pair<std::string, std::string>>& task);
 void parse_out(const std::string& outfile,
                std::vector<std::pair<std::string, std::string>>& task);
-void extract_energy(std::istream& from, const std::string& theory);
-void extract_optimized_energy(std::istream& from, const std::string& theory);
-void extract_zpe(std::istream& from, const std::string& theory);
+void extract_energy(Chem::Line_reader& from, const std::string& theory);
+void extract_optimized_energy(Chem::Line_reader& from,
+                              const std::string& theory);
+void extract_zpe(Chem::Line_reader& from, const std::string& theory);
 
 //------------------------------------------------------------------------------
 
@@ -98,11 +100,13 @@ void parse_nw(const std::string& nwfile,
 void parse_out(const std::string& outfile,
                std::vector<std::pair<std::string, std::string>>& task)
 {
-    std::ifstream from(outfile.c_str());
-    if (!from) {
+    Chem::Mapped_file file;
+    if (!file.open(outfile)) {
         throw IO_error("cannot open " + outfile);
     }
 
+    // Tasks are searched for in order, continuing from the previous task:
+    Chem::Line_reader from(file.view());
     for (auto it : task) {
         std::cout << "TASK " << it.first << ' ' << it.second << ":\n";
         if (it.second == "optimize") {
@@ -118,7 +122,7 @@ void parse_out(const std::string& outfile,
 }
 
 // Extract single-point electronic energy.
-void extract_energy(std::istream& from, const std::string& theory)
+void extract_energy(Chem::Line_reader& from, const std::string& theory)
 {
     std::string pat_mod;
     std::string pat_e;
@@ -132,16 +136,14 @@ void extract_energy(std::istream& from, const std::string& theory)
         pat_e = "Total DFT energy";
     }
 
-    std::string line;
-    std::string tmp;
+    Chem::Text_view line;
     std::string energy; // a bit dangerous, but easy (avoids loss of decimals)
 
-    while (std::getline(from, line)) {
-        if (line.find(pat_mod, 0) != std::string::npos) {
-            while (std::getline(from, line)) {
-                if (line.find(pat_e, 0) != std::string::npos) {
-                    std::istringstream iss(line);
-                    iss >> tmp >> tmp >> tmp >> tmp >> energy;
+    while (from.next(line)) {
+        if (line.contains(pat_mod)) {
+            while (from.next(line)) {
+                if (line.contains(pat_e)) {
+                    energy = Chem::get_token(line, 4).str();
                     std::cout << "  " << pat_e << " = " << energy << '\n';
                     return; // success
                 }
@@ -152,7 +154,8 @@ void extract_energy(std::istream& from, const std::string& theory)
 }
 
 // Extract electronic energy for optimized geometry.
-void extract_optimized_energy(std::istream& from, const std::string& theory)
+void extract_optimized_energy(Chem::Line_reader& from,
+                              const std::string& theory)
 {
     std::string pat_opt;
     std::string pat_mod;
@@ -171,20 +174,18 @@ void extract_optimized_energy(std::istream& from, const std::string& theory)
         pat_e = "Total DFT energy";
     }
 
-    std::string line;
-    std::string tmp;
+    Chem::Text_view line;
     std::string energy; // a bit dangerous, but easy (avoids loss of decimals)
 
-    while (std::getline(from, line)) {
-        if (line.find(pat_opt, 0) != std::string::npos) {
-            while (std::getline(from, line)) {
-                if (line.find(pat_mod, 0) != std::string::npos) {
-                    while (std::getline(from, line)) {
-                        if (line.find(pat_e, 0) != std::string::npos) {
-                            std::istringstream iss(line);
-                            iss >> tmp >> tmp >> tmp >> tmp >> energy;
+    while (from.next(line)) {
+        if (line.contains(pat_opt)) {
+            while (from.next(line)) {
+                if (line.contains(pat_mod)) {
+                    while (from.next(line)) {
+                        if (line.contains(pat_e)) {
+                            energy = Chem::get_token(line, 4).str();
                         }
-                        if (line.find(pat_conv, 0) != std::string::npos) {
+                        if (line.contains(pat_conv)) {
                             std::cout << "  " << pat_e << " = " << energy
                                       << '\n';
                             return; // success
@@ -198,7 +199,7 @@ void extract_optimized_energy(std::istream& from, const std::string& theory)
 }
 
 // Extract zero-point vibrational energy.
-void extract_zpe(std::istream& from, const std::string& theory)
+void extract_zpe(Chem::Line_reader& from, const std::string& theory)
 {
     std::string pat_freq;
     std::string pat_zpe;
@@ -214,19 +215,16 @@ void extract_zpe(std::istream& from, const std::string& theory)
         pat_mod = "NWChem DFT Module";
     }
 
-    std::string line;
-    std::string tmp;
+    Chem::Text_view line;
     std::string zpe; // a bit dangerous, but easy (avoids loss of decimals)
 
-    while (std::getline(from, line)) {
-        if (line.find(pat_freq, 0) != std::string::npos) {
-            while (std::getline(from, line)) {
-                if (line.find(pat_mod, 0) != std::string::npos) {
-                    while (std::getline(from, line)) {
-                        if (line.find(pat_zpe, 0) != std::string::npos) {
-                            std::istringstream iss(line);
-                            iss >> tmp >> tmp >> tmp >> tmp >> tmp >> tmp >>
-                                tmp >> tmp >> zpe;
+    while (from.next(line)) {
+        if (line.contains(pat_freq)) {
+            while (from.next(line)) {
+                if (line.contains(pat_mod)) {
+                    while (from.next(line)) {
+                        if (line.contains(pat_zpe)) {
+                            zpe = Chem::get_token(line, 8).str();
                             std::cout << "  " << pat_zpe << " = " << zpe
                                       << '\n';
                             return; // success
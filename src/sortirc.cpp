@@ -44,6 +44,14 @@ const std::string pattern_irc_grad =
 
 void print_array(std::ostream& to, const std::vector<double>& array);
 
+// Write IRC array point by point in forward or reverse order.
+void print_irc_array(std::ostream& to,
+                     const Chem::Gauss_data& gauss,
+                     void (Chem::Gauss_data::*get)(int, std::vector<double>&)
+                         const,
+                     int npoints,
+                     bool reverse);
+
 //------------------------------------------------------------------------------
 
 // Sort output data from a Gaussian 98/03 IRC calculation for input to
@@ -173,45 +181,20 @@ int main(int argc, char* argv[])
             print_array(to, mep);
         }
 
-        // Correct geometries/gradients and write to output:
-
-        std::vector<double> geom;
-        gauss.get_irc_geom(geom);
-
-        std::vector<double> grad;
-        gauss.get_irc_grad(grad);
-
-        if (reverse_geom) {
-            const int natoms3 = 3 * gauss.get_natoms();
-            const int npoints = static_cast<int>(mep.size() / 2);
-
-            std::vector<double> geom_rev(geom.size());
-            std::vector<double> grad_rev(grad.size());
+        // Write geometries/gradients one point at a time:
 
-            int indx1;
-            int indx2;
-            for (int i = 0; i < npoints; i++) {
-                indx1 = (npoints - 1 - i) * natoms3;
-                indx2 = i * natoms3;
-                for (int j = 0; j < natoms3; j++) {
-                    geom_rev[indx1 + j] = geom[indx2 + j];
-                    grad_rev[indx1 + j] = grad[indx2 + j];
-                }
-            }
+        const int natoms3 = gauss.get_irc_natoms3();
+        const int npoints = static_cast<int>(mep.size() / 2);
+        const std::size_t n = static_cast<std::size_t>(natoms3) * npoints;
 
-            to << pattern_irc_geom << fmt(geom_rev.size()) << '\n';
-            print_array(to, geom_rev);
+        to << pattern_irc_geom << fmt(n) << '\n';
+        print_irc_array(to, gauss, &Chem::Gauss_data::get_irc_geom, npoints,
+                        reverse_geom);
 
-            to << pattern_irc_grad << fmt(grad_rev.size()) << '\n';
-            print_array(to, grad_rev);
-        }
-        else {
-            to << pattern_irc_geom << fmt(geom.size()) << '\n';
-            print_array(to, geom);
+        to << pattern_irc_grad << fmt(n) << '\n';
+        print_irc_array(to, gauss, &Chem::Gauss_data::get_irc_grad, npoints,
+                        reverse_geom);
 
-            to << pattern_irc_grad << fmt(grad.size()) << '\n';
-            print_array(to, grad);
-        }
         std::cout << "Output is written to " << output_file << '\n';
     }
     catch (std::exception& e) {
@@ -224,24 +207,23 @@ int main(int argc, char* argv[])
 
 void print_array(std::ostream& to, const std::vector<double>& array)
 {
-    Stdutils::Format<double> sci;
-    sci.scientific_E().width(16).precision(8);
-
-    int count = 0;
-    bool wrote_endl = false;
-
-    for (auto v : array) {
-        to << sci(v);
-        count++;
-        wrote_endl = false;
-        if (count == 5) {
-            to << '\n';
-            count = 0;
-            wrote_endl = true;
-        }
-    }
-    if (!wrote_endl) {
-        to << '\n';
-    }
+    Chem::Fchk_writer writer(to);
+    writer.put(array);
+    writer.finish();
 }
 
+void print_irc_array(std::ostream& to,
+                     const Chem::Gauss_data& gauss,
+                     void (Chem::Gauss_data::*get)(int, std::vector<double>&)
+                         const,
+                     int npoints,
+                     bool reverse)
+{
+    Chem::Fchk_writer writer(to);
+    std::vector<double> point;
+    for (int i = 0; i < npoints; ++i) {
+        (gauss.*get)(reverse ? npoints - 1 - i : i, point);
+        writer.put(point);
+    }
+    writer.finish();
+}
@@ -0,0 +1,48 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/cascade.h>
+#include <chem/forcefield.h>
+#include <chem/molecule.h>
+#include <stdutils/stdutils.h>
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <vector>
+
+TEST_CASE("test_cascade")
+{
+    using namespace Chem;
+    using namespace Stdutils;
+
+    std::ifstream from;
+    fopen(from, "test_zmatrix.inp");
+
+    Molecule mol(from);
+
+    SECTION("run")
+    {
+        Cascade<Forcefield, Forcefield> pot;
+
+        Molecule m1 = mol;
+        pot.run(m1);
+        CHECK(m1.elec().energy() != 0.0); // first structure is promoted
+
+        Molecule m2 = mol;
+        pot.run(m2);
+        CHECK(m2.elec().energy() == 0.0); // duplicate is not promoted
+    }
+
+    SECTION("run_batch")
+    {
+        Cascade<Forcefield, Forcefield> pot;
+
+        std::vector<Molecule> mols(3, mol);
+        pot.run_batch(mols);
+        CHECK(mols[0].elec().energy() != 0.0);
+        CHECK(mols[1].elec().energy() == 0.0);
+        CHECK(mols[2].elec().energy() == 0.0);
+    }
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/conformer_arena.h>
+#include <chem/periodic_table.h>
+#include <numlib/matrix.h>
+#include <catch2/catch.hpp>
+#include <vector>
+
+TEST_CASE("test_conformer_arena")
+{
+    using namespace Chem;
+    using namespace Numlib;
+
+    std::vector<Element> atoms = {Periodic_table::get_element("O"),
+                                  Periodic_table::get_element("H"),
+                                  Periodic_table::get_element("H")};
+
+    Mat<double> xyz1 = {
+        {0.0, 0.0, 0.1173}, {0.0, 0.7572, -0.4692}, {0.0, -0.7572, -0.4692}};
+    Mat<double> xyz2 = {
+        {0.0, 0.0, 0.1173}, {0.0, 0.9572, -0.4692}, {0.0, -0.5572, -0.9692}};
+    Mat<double> xyz3 = {
+        {0.0, 0.0, 0.1173}, {0.0, 0.7572, -0.8692}, {0.0, -0.7572, -0.1692}};
+
+    Conformer_arena arena(atoms);
+    arena.push_back(-1.0, xyz1);
+    arena.push_back(-3.0, xyz2);
+    arena.push_back(-2.0, xyz3);
+
+    SECTION("sort")
+    {
+        arena.sort();
+        CHECK(arena.size() == 3);
+        CHECK(arena.energy(0) == -3.0);
+        CHECK(arena.energy(1) == -2.0);
+        CHECK(arena.energy(2) == -1.0);
+        CHECK(arena.get_xyz(0)(1, 1) == xyz2(1, 1));
+        CHECK(arena.get_xyz(2)(1, 1) == xyz1(1, 1));
+    }
+
+    SECTION("pop_back")
+    {
+        arena.use(2);
+        arena.sort();
+        arena.pop_back();
+        CHECK(arena.size() == 2);
+        CHECK(arena.energy(0) == -3.0);
+        CHECK(arena.energy(1) == -2.0);
+        CHECK(arena.usage(1) == 1);
+        CHECK(arena.get_xyz(1)(2, 2) == xyz3(2, 2));
+    }
+
+    SECTION("truncate")
+    {
+        arena.sort();
+        arena.truncate(1);
+        CHECK(arena.size() == 1);
+        CHECK(arena.energy(0) == -3.0);
+        CHECK(arena.get_xyz(0)(2, 2) == xyz2(2, 2));
+    }
+
+    SECTION("contains")
+    {
+        CHECK(arena.contains(xyz3, 1.0e-3));
+        CHECK(arena.contains(xyz3, 1.0e-3, -2.0, 1.0e-6));
+        CHECK(!arena.contains(xyz3, 1.0e-3, -1.0, 1.0e-6));
+    }
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/decompress_stream.h>
+#include <chem/gauss_data.h>
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#ifdef CHEMAPPS_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+// Create text of about 3 MB, spanning several chunks.
+std::string make_text()
+{
+    std::ostringstream os;
+    for (int i = 0; i < 100000; ++i) {
+        os << "line " << i << " value " << 0.5 * i << '\n';
+    }
+    return os.str();
+}
+
+// Check sequential reads and seeks against text.
+void check_stream(Chem::Decompress_istream& from, const std::string& text)
+{
+    std::string all((std::istreambuf_iterator<char>(from)),
+                    std::istreambuf_iterator<char>());
+    CHECK(all == text);
+
+    // Seek backward and forward across chunks:
+    const std::size_t pos[] = {0, 2500000, 17, 1500000, 3000, 2999999};
+    for (auto p : pos) {
+        if (p >= text.size()) {
+            continue;
+        }
+        from.clear();
+        from.seekg(static_cast<std::streamoff>(p));
+        CHECK(static_cast<std::size_t>(from.tellg()) == p);
+
+        std::string line;
+        std::getline(from, line);
+        auto end = text.find('\n', p);
+        CHECK(line == text.substr(p, end - p));
+        CHECK(static_cast<std::size_t>(from.tellg()) == end + 1);
+    }
+}
+
+} // namespace
+
+TEST_CASE("test_decompress_stream")
+{
+    using namespace Chem;
+
+    const std::string text = make_text();
+
+    SECTION("detect_compression")
+    {
+        const unsigned char gz[] = {0x1f, 0x8b, 0x08};
+        const unsigned char xz[] = {0xfd, '7', 'z', 'X', 'Z', 0x00};
+        const unsigned char zst[] = {0x28, 0xb5, 0x2f, 0xfd};
+        const unsigned char txt[] = {' ', 'E', 'n', 't'};
+        CHECK(detect_compression(gz, 3) == Compression::gzip);
+        CHECK(detect_compression(xz, 6) == Compression::xz);
+        CHECK(detect_compression(zst, 4) == Compression::zstd);
+        CHECK(detect_compression(txt, 4) == Compression::none);
+        CHECK(detect_compression(gz, 1) == Compression::none);
+    }
+
+    SECTION("plain")
+    {
+        {
+            std::ofstream to("test_decompress_stream.txt",
+                             std::ios_base::binary);
+            to << text;
+        }
+        Decompress_istream from("test_decompress_stream.txt");
+        CHECK(from.is_open());
+        CHECK(from.compression() == Compression::none);
+        check_stream(from, text);
+        from.close();
+        std::remove("test_decompress_stream.txt");
+    }
+
+    SECTION("missing_file")
+    {
+        Decompress_istream from("test_decompress_stream.missing");
+        CHECK(!from);
+        CHECK(!from.is_open());
+    }
+
+#ifdef CHEMAPPS_HAVE_ZLIB
+    SECTION("gzip")
+    {
+        // Write two gzip members:
+        const std::size_t half = text.size() / 2;
+        for (int k = 0; k < 2; ++k) {
+            gzFile gz = gzopen("test_decompress_stream.gz", k ? "ab" : "wb");
+            REQUIRE(gz != nullptr);
+            const std::size_t first = k ? half : 0;
+            const std::size_t n = k ? text.size() - half : half;
+            gzwrite(gz, text.data() + first, static_cast<unsigned>(n));
+            gzclose(gz);
+        }
+        Decompress_istream from("test_decompress_stream.gz");
+        CHECK(from.compression() == Compression::gzip);
+        check_stream(from, text);
+        from.close();
+        std::remove("test_decompress_stream.gz");
+    }
+
+    SECTION("gauss_data")
+    {
+        std::ifstream ref("test_gauss_data.inp", std::ios_base::binary);
+        std::string data((std::istreambuf_iterator<char>(ref)),
+                         std::istreambuf_iterator<char>());
+
+        gzFile gz = gzopen("test_gauss_data.fchk.gz", "wb");
+        REQUIRE(gz != nullptr);
+        gzwrite(gz, data.data(), static_cast<unsigned>(data.size()));
+        gzclose(gz);
+
+        Decompress_istream from("test_gauss_data.fchk.gz");
+        Gauss_data gauss(from, Chem::fchk);
+        CHECK(gauss.get_natoms() == 3);
+
+        Numlib::Symm_mat<double, Numlib::lo> hess;
+        gauss.get_hessians(hess);
+        CHECK(hess.size() == 45);
+        from.close();
+        std::remove("test_gauss_data.fchk.gz");
+    }
+#endif
+}
@@ -0,0 +1,114 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/forcefield.h>
+#include <chem/molecule.h>
+#include <numlib/constants.h>
+#include <numlib/matrix.h>
+#include <stdutils/stdutils.h>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+TEST_CASE("test_forcefield")
+{
+    using namespace Chem;
+    using namespace Numlib;
+    using namespace Stdutils;
+
+    std::ifstream from;
+    fopen(from, "test_forcefield.inp");
+
+    Molecule mol(from);
+    Forcefield ff(from);
+
+    SECTION("energy") { CHECK(ff.energy(mol) > 0.0); }
+
+    SECTION("optimization")
+    {
+        ff.run(mol);
+
+        const auto& xyz = mol.get_xyz();
+        double u[3];
+        double v[3];
+        for (Index k = 0; k < 3; ++k) {
+            u[k] = xyz(1, k) - xyz(0, k);
+            v[k] = xyz(2, k) - xyz(0, k);
+        }
+        double ru = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+        double rv = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        double theta = std::acos((u[0] * v[0] + u[1] * v[1] + u[2] * v[2]) /
+                                 (ru * rv)) *
+                       180.0 / Constants::pi;
+
+        CHECK(std::abs(ru - 0.97) < 1.0e-4);
+        CHECK(std::abs(rv - 0.97) < 1.0e-4);
+        CHECK(std::abs(theta - 104.5) < 1.0e-2);
+        CHECK(std::abs(mol.elec().energy()) < 1.0e-6);
+        CHECK(std::abs(ff.energy(mol) - mol.elec().energy()) < 1.0e-10);
+    }
+
+    SECTION("run_batch")
+    {
+        Molecule m = mol;
+        ff.run(m);
+
+        std::vector<Molecule> mols(4, mol);
+        ff.run_batch(mols);
+        for (const auto& mi : mols) {
+            CHECK(std::abs(mi.elec().energy() - m.elec().energy()) < 1.0e-10);
+        }
+    }
+
+    SECTION("failed")
+    {
+        // Failed optimizations are marked by an infinite energy, since
+        // force field energies may be zero or positive:
+        std::istringstream from_ff("Forcefield\n  maxiter = 1\nEnd\n");
+        Forcefield ff_short(from_ff);
+        ff_short.run(mol);
+        CHECK(std::isinf(mol.elec().energy()));
+    }
+
+    SECTION("butane")
+    {
+        std::ifstream from_zmat;
+        fopen(from_zmat, "test_zmatrix.inp");
+
+        Molecule butane(from_zmat);
+        Forcefield ff_default;
+
+        double e0 = ff_default.energy(butane);
+        ff_default.run(butane);
+        CHECK(std::isfinite(butane.elec().energy())); // converged
+        CHECK(butane.elec().energy() < e0);
+    }
+
+    SECTION("cyclohexane")
+    {
+        std::ifstream from_ring;
+        fopen(from_ring, "test_cyclohexane.inp");
+
+        Molecule ring(from_ring);
+        Forcefield ff_default;
+
+        ff_default.run(ring);
+        CHECK(std::isfinite(ring.elec().energy())); // converged
+
+        // The ring closure is bonded, so the ring stays intact:
+        const auto& xyz = ring.get_xyz();
+        for (Index i = 0; i < 6; ++i) {
+            Index j = (i + 1) % 6;
+            double r2 = 0.0;
+            for (Index k = 0; k < 3; ++k) {
+                r2 += (xyz(j, k) - xyz(i, k)) * (xyz(j, k) - xyz(i, k));
+            }
+            CHECK(std::abs(std::sqrt(r2) - 1.52) < 0.05);
+        }
+    }
+}
@@ -9,8 +9,10 @@
 #include <numlib/math.h>
 #include <stdutils/stdutils.h>
 #include <catch2/catch.hpp>
-#include <fstream>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <vector>
 
 TEST_CASE("test_gauss_data")
 {
@@ -39,5 +41,57 @@ TEST_CASE("test_gauss_data")
     for (Index i = 0; i < ans.size(); ++i) {
         CHECK(std::abs(hess.data()[i] - ans(i)) < 1.0e-12);
     }
+
+    SECTION("reuse_index")
+    {
+        // Getters share the section index and keep the stream position:
+        std::streampos pos = from.tellg();
+        CHECK(gauss.get_natoms() == 3);
+
+        Chem::Gauss_coord coord;
+        gauss.get_opt_cart_coord(coord);
+        CHECK(coord.atnum == std::vector<int>({8, 1, 1}));
+        CHECK(std::abs(coord.xyz(1, 1) - 1.43244) < 1.0e-5);
+        CHECK(std::abs(coord.xyz(2, 2) + 0.960973) < 1.0e-5);
+        CHECK(from.tellg() == pos);
+
+        gauss.get_hessians(hess);
+        CHECK(hess.size() == ans.size());
+    }
 }
 
+
+TEST_CASE("test_gauss_irc_point")
+{
+    {
+        std::ofstream to("test_gauss_irc.fchk");
+        to << "Number of atoms                            I                2\n"
+           << "IRC point       1 Results for each geome   R   N=           6\n"
+           << " -7.60000000E+01  0.00000000E+00 -7.61000000E+01  "
+              "1.00000000E-01 -7.62000000E+01\n"
+           << "  2.00000000E-01\n"
+           << "IRC point       1 Geometries               R   N=          18\n";
+        for (int i = 0; i < 18; ++i) {
+            to << ' ' << (i < 9 ? " " : "") << i + 1 << ".00000000E+00";
+            if (i % 5 == 4 || i == 17) {
+                to << '\n';
+            }
+        }
+    }
+    std::ifstream from("test_gauss_irc.fchk");
+    Chem::Gauss_data gauss(from, Chem::fchk);
+
+    std::vector<double> geom;
+    gauss.get_irc_geom(geom);
+    CHECK(geom.size() == 18);
+
+    // Points are read directly and in any order:
+    std::vector<double> point;
+    for (int k = 2; k >= 0; --k) {
+        gauss.get_irc_geom(k, point);
+        CHECK(point == std::vector<double>(geom.begin() + 6 * k,
+                                           geom.begin() + 6 * (k + 1)));
+    }
+    CHECK_THROWS(gauss.get_irc_geom(3, point));
+    std::remove("test_gauss_irc.fchk");
+}
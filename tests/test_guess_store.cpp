@@ -0,0 +1,67 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/guess_store.h>
+#include <chem/molecule.h>
+#include <numlib/matrix.h>
+#include <stdutils/stdutils.h>
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <string>
+
+TEST_CASE("test_guess_store")
+{
+    using namespace Chem;
+    using namespace Numlib;
+    using namespace Stdutils;
+
+    std::ifstream from;
+    fopen(from, "test_h2o.inp");
+
+    Molecule mol1(from);
+    Molecule mol2 = mol1;
+    Mat<double> xyz = mol2.get_xyz();
+    xyz(1, 1) += 0.3;
+    mol2.set_xyz(xyz);
+
+    {
+        std::ofstream to("test_guess_store1.chk");
+        to << "guess1\n";
+    }
+    {
+        std::ofstream to("test_guess_store2.chk");
+        to << "guess2\n";
+    }
+
+    Guess_store store("test_guess_store.d", ".chk", 2);
+    CHECK(!store.fetch(mol1, 0.5, "test_guess_store.out"));
+
+    store.store(mol1, "test_guess_store1.chk");
+    store.store(mol2, "test_guess_store2.chk");
+    CHECK(store.size() == 2);
+
+    auto read_guess = []() {
+        std::ifstream in("test_guess_store.out");
+        std::string line;
+        std::getline(in, line);
+        return line;
+    };
+
+    CHECK(store.fetch(mol1, 0.5, "test_guess_store.out"));
+    CHECK(read_guess() == "guess1");
+
+    CHECK(store.fetch(mol2, 0.5, "test_guess_store.out"));
+    CHECK(read_guess() == "guess2");
+
+    // Oldest entry is replaced when the store is full:
+    Molecule mol3 = mol1;
+    xyz = mol3.get_xyz();
+    xyz(2, 2) += 0.4;
+    mol3.set_xyz(xyz);
+    store.store(mol3, "test_guess_store2.chk");
+    CHECK(store.size() == 2);
+    CHECK(!store.fetch(mol1, 0.01, "test_guess_store.out"));
+}
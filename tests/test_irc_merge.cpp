@@ -0,0 +1,92 @@
+// Copyright (c) 2018 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/gauss_data.h>
+#include <chem/irc_merge.h>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Write array in fchk format.
+void write_array(std::ostream& to,
+                 const std::string& pattern,
+                 const std::vector<double>& x)
+{
+    to << pattern << std::setw(12) << x.size() << '\n'
+       << std::scientific << std::uppercase << std::setprecision(8);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        to << std::setw(16) << x[i];
+        if (i % 5 == 4 || i + 1 == x.size()) {
+            to << '\n';
+        }
+    }
+}
+
+// Write IRC segment in the format of sortirc, which holds the IRC arrays
+// only; coordinates and gradients of each point are given by its SMEP.
+void write_segment(std::ostream& to, const std::vector<double>& smep)
+{
+    std::vector<double> mep;
+    std::vector<double> geom;
+    std::vector<double> grad;
+    for (auto s : smep) {
+        mep.push_back(-76.0 - s);
+        mep.push_back(s);
+        for (int i = 0; i < 6; ++i) {
+            geom.push_back(10.0 * s + i);
+            grad.push_back(-10.0 * s - i);
+        }
+    }
+    write_array(to, "IRC point       1 Results for each geome   R   N=", mep);
+    write_array(to, "IRC point       1 Geometries               R   N=", geom);
+    write_array(to, "IRC point       1 Gradient at each geome   R   N=", grad);
+}
+
+} // namespace
+
+TEST_CASE("test_irc_merge")
+{
+    std::stringstream seg1;
+    std::stringstream seg2;
+    write_segment(seg1, {0.3, 0.4});
+    write_segment(seg2, {0.0, 0.1, 0.2, 0.3});
+
+    Chem::Gauss_data gauss1(seg1, Chem::fchk);
+    Chem::Gauss_data gauss2(seg2, Chem::fchk);
+    CHECK(gauss1.get_irc_natoms3() == 6);
+
+    std::stringstream res;
+    CHECK(Chem::merge_irc({&gauss1, &gauss2}, res) == 5);
+
+    // Points are merged by SMEP with the duplicate point written once:
+    Chem::Gauss_data gauss(res, Chem::fchk);
+    CHECK(gauss.get_no_irc_points() == 5);
+    CHECK(gauss.get_irc_natoms3() == 6);
+
+    std::vector<double> geom;
+    std::vector<double> grad;
+    for (int k = 0; k < 5; ++k) {
+        double vmep;
+        double smep;
+        gauss.get_irc_data(k, vmep, smep);
+        CHECK(std::abs(smep - 0.1 * k) < 1.0e-12);
+        CHECK(std::abs(vmep + 76.0 + 0.1 * k) < 1.0e-12);
+
+        gauss.get_irc_geom(k, geom);
+        gauss.get_irc_grad(k, grad);
+        REQUIRE(geom.size() == 6);
+        REQUIRE(grad.size() == 6);
+        for (int i = 0; i < 6; ++i) {
+            CHECK(std::abs(geom[i] - (k + i)) < 1.0e-12);
+            CHECK(std::abs(grad[i] + (k + i)) < 1.0e-12);
+        }
+    }
+}
@@ -0,0 +1,275 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/ising.h>
+#include <chem/ising_msc.h>
+#include <chem/ising_pt.h>
+#include <chem/ising_snapshot.h>
+#include <chem/ising_wl.h>
+#include <chem/philox.h>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <vector>
+
+TEST_CASE("test_ising")
+{
+    SECTION("philox")
+    {
+        // Known-answer tests from the Random123 distribution:
+        Chem::Philox4x32 rng1;
+        CHECK(rng1({0, 0, 0, 0}) == Chem::Philox4x32::ctr_type(
+                                        {0x6627e8d5, 0xe169c58d, 0xbc57ac4c,
+                                         0x9b00dbd8}));
+
+        Chem::Philox4x32 rng2(0x299f31d0a4093822);
+        CHECK(rng2({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}) ==
+              Chem::Philox4x32::ctr_type(
+                  {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+    }
+
+    SECTION("metropolis")
+    {
+        Chem::Ising2D ising1(16, 1.0, 0.0, {}, 42);
+        Chem::Ising2D ising2(16, 1.0, 0.0, {}, 42);
+
+        auto res1 = ising1.metropolis(1.0, 200);
+        auto res2 = ising2.metropolis(1.0, 200);
+        CHECK(res1 == res2); // reproducible for a given seed
+
+        // Nearly ordered at low temperature:
+        CHECK(std::abs(res1[0] + 2.0) < 0.02);
+        CHECK(std::abs(std::abs(res1[1]) - 1.0) < 0.01);
+
+        // Disordered at high temperature:
+        auto res3 = ising1.metropolis(10.0, 200);
+        CHECK(std::abs(res3[1]) < 0.2);
+    }
+
+    SECTION("autocorr_time")
+    {
+        // AR(1) series with autocorrelation 0.9^t has tau = 9.5:
+        std::mt19937_64 mt(42);
+        std::normal_distribution<double> rnorm;
+        std::vector<double> x(200000);
+        x[0] = 0.0;
+        for (std::size_t i = 1; i < x.size(); ++i) {
+            x[i] = 0.9 * x[i - 1] + rnorm(mt);
+        }
+        CHECK(std::abs(Chem::autocorr_time(x) - 9.5) < 1.0);
+        CHECK(Chem::autocorr_time(std::vector<double>(10, 1.0)) == 0.5);
+    }
+
+    SECTION("cluster")
+    {
+        Chem::Ising2D ising1(16, 1.0, 0.0, {}, 42);
+        Chem::Ising2D ising2(16, 1.0, 0.0, {}, 42);
+
+        auto res1 = ising1.wolff(1.0, 200);
+        auto res2 = ising2.wolff(1.0, 200);
+        CHECK(res1 == res2);
+        CHECK(std::abs(res1[0] + 2.0) < 0.02);
+        CHECK(std::abs(res1[1] - 1.0) < 0.01);
+
+        auto res3 = ising1.swendsen_wang(1.0, 200);
+        CHECK(std::abs(res3[0] + 2.0) < 0.02);
+        CHECK(std::abs(res3[1] - 1.0) < 0.01);
+
+        // Cluster updates decorrelate faster than Metropolis near Tc:
+        Chem::Ising2D ising3(16, 1.0, 0.0, {}, 42);
+        auto res4 = ising3.wolff(2.269, 2000);
+        auto res5 = ising3.swendsen_wang(2.269, 2000);
+        CHECK(res4[5] < 5.0);
+        CHECK(res5[5] < 10.0);
+
+        auto res6 = ising1.swendsen_wang(10.0, 200);
+        CHECK(res6[1] < 0.2);
+    }
+
+    SECTION("correlation")
+    {
+        // Size with factors 2 and 3 to cover the mixed-radix transform:
+        const int n = 12;
+        Chem::Ising2D ising(n, 1.0, 0.0, {}, 42);
+        ising.set_corr_stride(1);
+        auto res = ising.metropolis(3.0, 2000);
+
+        // S(0) = <M^2> / N when every sweep is measured:
+        auto sfac = ising.structure_factor();
+        CHECK(std::abs(sfac(0, 0) - (3.0 * res[3] + n * n * res[1] * res[1])) <
+              1.0e-8 * sfac(0, 0));
+
+        auto g = ising.correlation();
+        CHECK(std::abs(g(0, 0) - 1.0) < 1.0e-12);
+        CHECK(std::abs(g(1, 0) - g(n - 1, 0)) < 1.0e-12);
+        CHECK(std::abs(g(0, 1) - g(0, n - 1)) < 1.0e-12);
+        CHECK(g(0, 1) > g(0, 2));
+
+        // The correlation length grows towards the critical temperature:
+        const double xi1 = ising.correlation_length();
+        ising.metropolis(2.4, 2000);
+        const double xi2 = ising.correlation_length();
+        CHECK(xi1 > 0.5);
+        CHECK(xi2 > 2.0 * xi1);
+    }
+
+    SECTION("correlation_prime")
+    {
+        // Prime size to cover Bluestein's algorithm:
+        const int n = 37;
+        Chem::Ising2D ising(n, 1.0, 0.0, {}, 42);
+        ising.set_corr_stride(1);
+        auto res = ising.metropolis(3.0, 200);
+
+        auto sfac = ising.structure_factor();
+        CHECK(std::abs(sfac(0, 0) - (3.0 * res[3] + n * n * res[1] * res[1])) <
+              1.0e-8 * sfac(0, 0));
+
+        auto g = ising.correlation();
+        CHECK(std::abs(g(0, 0) - 1.0) < 1.0e-12);
+        CHECK(std::abs(g(1, 0) - g(n - 1, 0)) < 1.0e-12);
+    }
+
+    // Exact energy per site of the 4x4 lattice by enumeration:
+    auto exact_energy = [](double temp) {
+        const int n = 4;
+        double z = 0.0;
+        double e1 = 0.0;
+        for (int c = 0; c < (1 << (n * n)); ++c) {
+            auto s = [&](int i, int j) {
+                return (c >> ((i % n) * n + j % n)) & 1 ? 1 : -1;
+            };
+            int e = 0;
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    e -= s(i, j) * (s(i, j + 1) + s(i + 1, j));
+                }
+            }
+            const double w = std::exp(-e / temp);
+            z += w;
+            e1 += w * e;
+        }
+        return e1 / z / (n * n);
+    };
+
+    SECTION("tempering")
+    {
+        std::vector<double> temps = {1.8, 2.1, 2.4, 2.7};
+        Chem::Ising2D_pt pt1(4, 1.0, 0.0, temps, 42);
+        Chem::Ising2D_pt pt2(4, 1.0, 0.0, temps, 42);
+
+        auto res1 = pt1.tempering(20000);
+        auto res2 = pt2.tempering(20000);
+        CHECK(res1 == res2);
+
+        for (auto r : pt1.exchange_rates()) {
+            CHECK(r > 0.5);
+        }
+        for (std::size_t k = 0; k < temps.size(); ++k) {
+            CHECK(std::abs(res1[k][0] - exact_energy(temps[k])) < 0.02);
+        }
+        // Reweighting between sampled temperatures:
+        CHECK(std::abs(pt1.reweight(2.25)[0] - exact_energy(2.25)) < 0.02);
+    }
+
+    SECTION("wang_landau")
+    {
+        Chem::Ising2D_wl wl(4, 1.0, 2, 0.5, 42);
+        wl.wang_landau(1.0e-5);
+
+        // Ground state is doubly degenerate; 2^16 states in total:
+        CHECK(std::abs(wl.log_dos()[0] - std::log(2.0)) < 0.05);
+        CHECK(wl.energies()[0] == -32.0);
+        for (double t : {1.5, 2.3, 3.0}) {
+            CHECK(std::abs(wl.thermo(t)[0] - exact_energy(t)) < 0.02);
+        }
+    }
+
+    SECTION("wang_landau_odd")
+    {
+        // On odd lattices every row and column has a satisfied bond, which
+        // bounds the highest energy at 2N - 4L:
+        const int n = 5;
+        Chem::Ising2D_wl wl(n, 1.0, 8, 0.5, 42);
+        wl.wang_landau(1.0e-4);
+
+        CHECK(std::abs(wl.log_dos()[0] - std::log(2.0)) < 0.05);
+        CHECK(wl.energies()[0] == -2.0 * n * n);
+        CHECK(wl.energies().back() == 2.0 * n * n - 4.0 * n);
+    }
+
+    SECTION("msc")
+    {
+        Chem::Ising2D_msc ising1(128, 1.0, 0.0, {}, 42);
+        Chem::Ising2D_msc ising2(128, 1.0, 0.0, {}, 42);
+
+        auto res1 = ising1.metropolis(1.0, 200);
+        auto res2 = ising2.metropolis(1.0, 200);
+        CHECK(res1 == res2);
+
+        CHECK(std::abs(res1[0] + 2.0) < 0.02);
+        CHECK(std::abs(std::abs(res1[1]) - 1.0) < 0.01);
+
+        auto res3 = ising1.metropolis(10.0, 200);
+        CHECK(std::abs(res3[1]) < 0.2);
+    }
+
+    SECTION("snapshot")
+    {
+        const int rows = 5;
+        const int cols = 7;
+        auto spin = [](int k, int i, int j) {
+            return (i * cols + j + k) % 3 == 0 ? 1 : -1;
+        };
+        {
+            Chem::Snapshot_writer snap("test_ising.snap", rows, cols, 2);
+            for (int k = 0; k < 10; ++k) {
+                snap.write(0.5 * k, 10 * k,
+                           Chem::pack_spins(rows, cols, [&](int i, int j) {
+                               return spin(k, i, j);
+                           }));
+            }
+            snap.close();
+        }
+        Chem::Snapshot_reader snap("test_ising.snap");
+        CHECK(snap.rows() == rows);
+        CHECK(snap.cols() == cols);
+        CHECK(snap.size() == 10);
+
+        double temp;
+        int it;
+        std::vector<int> spins;
+        for (int k = 9; k >= 0; --k) { // random access through index
+            snap.read(k, temp, it, spins);
+            CHECK(temp == 0.5 * k);
+            CHECK(it == 10 * k);
+            bool ok = true;
+            for (int i = 0; i < rows; ++i) {
+                for (int j = 0; j < cols; ++j) {
+                    ok = ok && spins[i * cols + j] == spin(k, i, j);
+                }
+            }
+            CHECK(ok);
+        }
+
+        // Complete frames are read if the index is missing:
+        std::ifstream from("test_ising.snap", std::ios_base::binary);
+        std::vector<char> buf((std::istreambuf_iterator<char>(from)),
+                              std::istreambuf_iterator<char>());
+        from.close();
+        const std::size_t frame = sizeof(double) + 4 + (rows * cols + 7) / 8;
+        buf.resize(16 + 3 * frame + frame / 2);
+        std::ofstream to("test_ising.snap", std::ios_base::binary);
+        to.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        to.close();
+
+        Chem::Snapshot_reader trunc("test_ising.snap");
+        CHECK(trunc.size() == 3);
+        trunc.read(2, temp, it, spins);
+        CHECK(it == 20);
+    }
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/mapped_file.h>
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("test_mapped_file")
+{
+    using namespace Chem;
+
+    SECTION("lines")
+    {
+        {
+            std::ofstream to("test_mapped_file.txt", std::ios_base::binary);
+            to << "first line\r\n second  1.5D+00 \n\nlast";
+        }
+        Mapped_file file("test_mapped_file.txt");
+        CHECK(file.is_open());
+        CHECK(file.size() == 35);
+
+        Line_reader from(file.view());
+        std::vector<std::string> lines;
+        Text_view line;
+        while (from.next(line)) {
+            lines.push_back(line.str());
+        }
+        CHECK(lines == std::vector<std::string>(
+                           {"first line", " second  1.5D+00 ", "", "last"}));
+
+        // Reverse scan:
+        lines.clear();
+        while (from.prev(line)) {
+            lines.push_back(line.str());
+        }
+        CHECK(lines == std::vector<std::string>(
+                           {"last", "", " second  1.5D+00 ", "first line"}));
+
+        from.next(line);
+        from.next(line);
+        CHECK(line.contains("second"));
+        CHECK(line.find("1.5") == 9);
+        CHECK(get_token(line, 0).str() == "second");
+        CHECK(get_token(line, 2).empty());
+
+        double x;
+        CHECK(parse_double(get_token(line, 1), x));
+        CHECK(x == 1.5);
+
+        std::remove("test_mapped_file.txt");
+    }
+
+    SECTION("missing_file")
+    {
+        Mapped_file file;
+        CHECK(!file.open("test_mapped_file.missing"));
+        CHECK_THROWS_AS(Mapped_file("test_mapped_file.missing"),
+                        std::runtime_error);
+    }
+
+    SECTION("parse_double")
+    {
+        const char* str[] = {"-76.4089620",    "1.23456789E-05",
+                             "-4.02292324E-01", "0.5D-3",
+                             "2.5d+02",         "  +7",
+                             ".25",             "1.0000000000000000000001"};
+        const double ans[] = {-76.4089620, 1.23456789e-05, -4.02292324e-01,
+                              0.5e-3,      2.5e+02,        7.0,
+                              0.25,        1.0};
+
+        for (std::size_t i = 0; i < 8; ++i) {
+            const char* p = str[i];
+            double x;
+            CHECK(parse_double(p, str[i] + std::strlen(str[i]), x));
+            CHECK(x == ans[i]);
+            CHECK(*p == '\0');
+        }
+
+        double x;
+        CHECK(!parse_double(Text_view("abc", 3), x));
+        CHECK(!parse_double(Text_view("1.0x", 4), x));
+    }
+
+    SECTION("parse_int")
+    {
+        long n;
+        CHECK(parse_int(Text_view(" -42 ", 5), n));
+        CHECK(n == -42);
+        CHECK(!parse_int(Text_view("4.2", 3), n));
+    }
+}
@@ -62,4 +62,24 @@ TEST_CASE("test_molecule")
             }
         }
     }
+
+    SECTION("set_xyz")
+    {
+        // Derived properties follow the coordinates when accessed:
+        Molecule mol2 = mol;
+        auto xyz = mol.get_xyz();
+        for (auto& x : xyz) {
+            x *= 1.1;
+        }
+        mol2.set_xyz(xyz);
+        CHECK(mol2.elec().energy() == 0.0);
+        CHECK(std::abs(mol2.geom().get_distance(1) -
+                       1.1 * mol.geom().get_distance(1)) < 1.0e-12);
+
+        auto pmom = mol.rot().principal_moments();
+        auto pmom2 = mol2.rot().principal_moments();
+        for (Index i = 0; i < pmom.size(); ++i) {
+            CHECK(std::abs(pmom2(i) - 1.21 * pmom(i)) < 1.0e-8 * pmom(i));
+        }
+    }
 }
@@ -6,6 +6,7 @@
 
 #include <chem/periodic_table.h>
 #include <catch2/catch.hpp>
+#include <string>
 
 TEST_CASE("test_periodic_table")
 {
@@ -24,4 +25,24 @@ TEST_CASE("test_periodic_table")
     }
 
     SECTION("atomic_number") { CHECK(get_atomic_symbol(15) == "P"); }
+
+    SECTION("Element_ref")
+    {
+        auto d = get_element_ref("D");
+        CHECK(std::string(d.atomic_symbol()) == "D");
+        CHECK(d.atomic_number() == 1);
+        CHECK(d.mass_number() == 2);
+        CHECK(d == find_element("D"));
+        CHECK(d != get_element_ref("H"));
+
+        for (int i = 0; i <= get_max_atomic_number(); ++i) {
+            auto elem = find_element(get_atomic_symbol(i));
+            CHECK(elem.valid());
+            CHECK(elem.atomic_number() == i);
+        }
+        CHECK(!find_element("Xx").valid());
+        CHECK_THROWS_AS(get_element_ref("Xx"), Bad_atomic_symbol);
+        CHECK(atomic_symbol_is_valid(" Og "));
+        CHECK(!atomic_symbol_is_valid("og"));
+    }
 }
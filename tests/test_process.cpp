@@ -0,0 +1,31 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/process.h>
+#include <catch2/catch.hpp>
+
+TEST_CASE("test_process")
+{
+    using namespace Chem;
+
+    SECTION("exit_status")
+    {
+        Process proc("exit 3");
+        CHECK(proc.wait() == 3);
+        CHECK(!proc.running());
+    }
+
+#ifndef _WIN32
+    SECTION("kill")
+    {
+        Process proc("sleep 30");
+        CHECK(proc.running());
+        proc.kill();
+        CHECK(!proc.running());
+        CHECK(proc.wait() != 0);
+    }
+#endif
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/molecule.h>
+#include <chem/qm_cache.h>
+#include <numlib/matrix.h>
+#include <stdutils/stdutils.h>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <fstream>
+
+TEST_CASE("test_qm_cache")
+{
+    using namespace Chem;
+    using namespace Numlib;
+    using namespace Stdutils;
+
+    std::ifstream from;
+    fopen(from, "test_h2o.inp");
+
+    Molecule mol(from);
+
+    SECTION("fnv1a_hash")
+    {
+        CHECK(fnv1a_hash("") == 0xcbf29ce484222325ULL);
+        CHECK(fnv1a_hash("a") == 0xaf63dc4c8601ec8cULL);
+    }
+
+    SECTION("key")
+    {
+        Qm_cache cache("test_qm_cache.d", 1.0e-4);
+
+        std::string k = cache.key("hf/sto-3g", mol);
+        CHECK(k != cache.key("b3lyp/6-31g", mol));
+
+        // Translation does not change the key:
+        Molecule m = mol;
+        Mat<double> xyz = m.get_xyz();
+        for (Index i = 0; i < xyz.rows(); ++i) {
+            xyz(i, 0) += 1.0;
+        }
+        m.set_xyz(xyz);
+        CHECK(k == cache.key("hf/sto-3g", m));
+
+        // Distortion beyond the tolerance does:
+        xyz(1, 2) += 0.01;
+        m.set_xyz(xyz);
+        CHECK(k != cache.key("hf/sto-3g", m));
+    }
+
+    SECTION("store_lookup")
+    {
+        Molecule m = mol;
+        m.elec().set_energy(-76.0123456789);
+        {
+            Qm_cache cache("test_qm_cache.d", 1.0e-4);
+            cache.store(cache.key("opt hf/sto-3g", mol), m);
+        }
+
+        // A new cache instance reads the entry from disk:
+        Qm_cache cache("test_qm_cache.d", 1.0e-4);
+        Molecule res = mol;
+        CHECK(cache.lookup(cache.key("opt hf/sto-3g", mol), res));
+        CHECK(res.elec().energy() == m.elec().energy());
+        CHECK(!cache.lookup(cache.key("opt hf/3-21g", mol), res));
+    }
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2020 Stig Rune Sellevag
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <chem/rmsd.h>
+#include <numlib/matrix.h>
+#include <numlib/math.h>
+#include <catch2/catch.hpp>
+#include <cmath>
+
+TEST_CASE("test_rmsd")
+{
+    using namespace Numlib;
+
+    Mat<double> xyz = {{-0.4737, 2.1124, 0.0000},  {0.4737, 0.5918, 0.0000},
+                       {-0.4737, -0.5918, 0.0000}, {0.4737, -2.1124, 0.0000},
+                       {-1.0946, -0.5992, 0.8807}, {-1.0946, -0.5992, -0.8807},
+                       {1.0946, 0.5992, 0.8807},   {1.0946, 0.5992, -0.8807}};
+
+    // Rotate about the z axis and translate:
+    const double phi = 0.7;
+    Mat<double> xyz_rot = xyz;
+    for (Index i = 0; i < xyz.rows(); ++i) {
+        xyz_rot(i, 0) = std::cos(phi) * xyz(i, 0) - std::sin(phi) * xyz(i, 1);
+        xyz_rot(i, 1) = std::sin(phi) * xyz(i, 0) + std::cos(phi) * xyz(i, 1);
+        xyz_rot(i, 2) = xyz(i, 2) + 1.5;
+    }
+
+    // Distort the structure:
+    Mat<double> xyz_dist = xyz_rot;
+    for (Index i = 0; i < xyz.rows(); ++i) {
+        xyz_dist(i, 0) += 0.05 * std::sin(1.0 + i);
+        xyz_dist(i, 1) -= 0.08 * std::cos(2.0 * i);
+        xyz_dist(i, 2) += 0.03 * i;
+    }
+
+    SECTION("superposition") { CHECK(Chem::qcp_rmsd(xyz, xyz_rot) < 1.0e-6); }
+
+    SECTION("kabsch")
+    {
+        double ans = Numlib::kabsch_rmsd(xyz, xyz_dist);
+        CHECK(std::abs(Chem::qcp_rmsd(xyz, xyz_dist) - ans) < 1.0e-8);
+        CHECK(std::abs(Chem::qcp_rmsd(xyz_dist, xyz) - ans) < 1.0e-8);
+    }
+
+    SECTION("early_exit")
+    {
+        double ans = Chem::qcp_rmsd(xyz, xyz_dist);
+        CHECK(Chem::qcp_rmsd(xyz, xyz_dist, 2.0 * ans) == Approx(ans));
+
+        double res = Chem::qcp_rmsd(xyz, xyz_dist, 0.1 * ans);
+        CHECK(res > 0.1 * ans);
+        CHECK(res <= ans + 1.0e-12);
+    }
+}